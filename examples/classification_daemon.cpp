@@ -0,0 +1,86 @@
+#include "common.hpp"
+#include <csignal>
+#include <cspc/algorithms.hpp>
+#include <cspc/daemon.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/fast_path.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/metrics.hpp>
+#include <cspc/witness_cache.hpp>
+#include <spdlog/spdlog.h>
+
+// every cached polymorphism is tried on a miss, so the cache is kept small
+constexpr auto WITNESS_CACHE_CAPACITY = size_t{64};
+
+// usage:
+//   classification_daemon <socket path> <threads> [<metrics socket path>]
+//     answers siggers classification requests until interrupted, serving Prometheus metrics on
+//     the metrics socket if given
+//   classification_daemon --query <socket path> <arity> <domain size>
+//     classifies every relation of all_nary_relations through a running daemon
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv, argv + argc);
+	if (argc == 5 && args[1] == "--query") {
+		// throws
+		const auto n = std::stoul(args[3]);
+		const auto d = std::stoul(args[4]);
+		if (n < 2 || d < 2) {
+			spdlog::error("Arity and domain must be >1");
+			return EXIT_FAILURE;
+		}
+		const auto relations = cspc::all_nary_relations(n, d);
+		const auto results = cspc::classify_remote(args[2], relations);
+		if (!results.has_value()) {
+			return EXIT_FAILURE;
+		}
+		print_results(relations, results.value());
+		return EXIT_SUCCESS;
+	}
+	if (argc != 3 && argc != 4) {
+		spdlog::error("Incorrect number of arguments");
+		return EXIT_FAILURE;
+	}
+	// throws
+	const auto n_threads = std::stoul(args[2]);
+
+	// the worker threads inherit the blocked signals, so only sigwait below receives them
+	auto signals = sigset_t{};
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	// shared by every worker, so a polymorphism found for one request answers later ones
+	const auto witnesses = std::make_shared<cspc::witness_cache>(WITNESS_CACHE_CAPACITY);
+	const auto create_checker = [witnesses]() {
+		return cspc::create_fast_path_checker(
+			cspc::siggers_operation(), cspc::default_fast_path_rules(),
+			cspc::create_witness_caching_solver(
+				cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+				cspc::decode_direct_assignment, cspc::kissat_find_model, witnesses));
+	};
+	auto daemon = cspc::classification_daemon(
+		create_checker,
+		cspc::daemon_options{
+			.n_threads = n_threads,
+			.result_cache_capacity = 1 << 20,
+			.max_request_size = 1 << 20,
+		});
+	if (!daemon.listen(args[1])) {
+		return EXIT_FAILURE;
+	}
+	auto metrics = cspc::metrics_socket_exporter(cspc::global_metrics());
+	if (argc == 4 && !metrics.listen(args[3])) {
+		return EXIT_FAILURE;
+	}
+	spdlog::info("Listening on {} with {} threads", args[1], n_threads);
+
+	auto signal = 0;
+	sigwait(&signals, &signal);
+	daemon.stop();
+	metrics.stop();
+	spdlog::info(
+		"Answered {} requests, {} from the result cache", daemon.n_requests(),
+		daemon.n_cache_hits());
+	return EXIT_SUCCESS;
+}
@@ -3,7 +3,10 @@
 #include "gautil/functional.hpp"
 #include <chrono>
 #include <cspc/algorithms.hpp>
+#include <cspc/fast_path.hpp>
+#include <cspc/journal.hpp>
 #include <cspc/kissat.hpp>
+#include <gautil/progress.hpp>
 #include <ranges>
 #include <spdlog/spdlog.h>
 
@@ -11,9 +14,36 @@ auto duration_to_precise_ms(auto duration) -> f64 {
 	return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / std::pow(10, 6);
 }
 
+namespace {
+const auto fast_path_rules = cspc::default_fast_path_rules();
+const auto fast_path_statistics =
+	std::make_shared<cspc::fast_path_statistics>(fast_path_rules.size());
+} // namespace
+
 auto encoding_siggers_checker() -> cspc::polymorphism_checker {
-	return cspc::create_encoding_solver(
-		cspc::siggers_operation(), cspc::multivalued_direct_encoding, cspc::kissat_is_satisfiable);
+	return cspc::create_fast_path_checker(
+		cspc::siggers_operation(), fast_path_rules,
+		cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+			cspc::kissat_is_satisfiable),
+		fast_path_statistics);
+}
+
+auto print_fast_path_statistics() -> void {
+	const auto n_hits = gautil::fold(
+		std::views::iota(0u, fast_path_statistics->n_rules()), 0ul, std::plus{},
+		[&](size_t i) { return fast_path_statistics->hits(i); });
+	if (n_hits == 0) {
+		return;
+	}
+	spdlog::info("");
+	spdlog::info("Fast path:");
+	spdlog::info("{:<30} │ {}", "Rule", "Relations");
+	spdlog::info("───────────────────────────────┼─────────────");
+	for (auto i = 0u; i < fast_path_rules.size(); ++i) {
+		spdlog::info("{:<30} │ {:>10}", fast_path_rules[i].name, fast_path_statistics->hits(i));
+	}
+	spdlog::info("{:<30} │ {:>10}", "Solved", fast_path_statistics->misses());
 }
 
 auto check_single(cspc::relation const& relation, cspc::polymorphism_checker checker) -> void {
@@ -25,8 +55,23 @@ auto check_single(cspc::relation const& relation, cspc::polymorphism_checker che
 	spdlog::info("Job took {} ms", duration_to_precise_ms(time_after - time_before));
 }
 
-auto check_all_nary_on_domain(size_t n, size_t domain_size, cspc::polymorphism_checker checker)
-	-> void {
+auto print_results(
+	std::vector<cspc::relation> const& relations,
+	std::vector<cspc::satisfiability> const& satisfiability) -> void {
+	spdlog::info("Results:");
+	spdlog::info("{:<10} │ {}", "Class", "cspc::relation");
+	spdlog::info("───────────┼─────────");
+	std::ranges::for_each(std::views::iota(0u, satisfiability.size()), [&](size_t i) {
+		const auto label = satisfiability[i] == cspc::SATISFIABLE ? "P" : "NP-hard";
+		spdlog::info("{:<10} │ {}", label, relations[i]);
+	});
+}
+
+auto check_all_nary_on_domain(
+	size_t n,
+	size_t domain_size,
+	cspc::polymorphism_checker checker,
+	std::optional<std::filesystem::path> journal_path) -> void {
 	const auto time_before = std::chrono::system_clock::now();
 
 	// set up relations
@@ -37,8 +82,40 @@ auto check_all_nary_on_domain(size_t n, size_t domain_size, cspc::polymorphism_c
 	auto satisfiability = std::vector<cspc::satisfiability>{};
 	satisfiability.reserve(relations.size());
 
-	// std::ranges::transform but with a progress bar
-	gautil::transform_and_print_progress(relations, std::back_inserter(satisfiability), checker);
+	auto journal = std::unique_ptr<cspc::journal>{};
+	if (journal_path.has_value()) {
+		journal = cspc::journal::open(journal_path.value(), fmt::format("n={} d={}", n, domain_size));
+		if (journal == nullptr) {
+			exit(EXIT_FAILURE);
+		}
+		if (journal->size() > 0) {
+			spdlog::info("Resuming with {} journaled relations", journal->size());
+		}
+	}
+	{
+		auto progress = gautil::progress_tracker(relations.size());
+		for (auto i = size_t(0); i < relations.size(); ++i) {
+			const auto maybe_entry = journal == nullptr ? std::nullopt : journal->find(i);
+			if (maybe_entry.has_value()) {
+				satisfiability.push_back(maybe_entry->result);
+				progress.skip(1);
+				continue;
+			}
+			const auto time_before = std::chrono::steady_clock::now();
+			satisfiability.push_back(checker(relations[i]));
+			const auto solve_time = std::chrono::steady_clock::now() - time_before;
+			progress.record(solve_time);
+			if (journal != nullptr) {
+				journal->record(cspc::journal_entry{
+					.index = i,
+					.result = satisfiability.back(),
+					.solve_time_ns = u64(
+						std::chrono::duration_cast<std::chrono::nanoseconds>(solve_time).count()),
+				});
+			}
+		}
+	}
+	journal.reset();
 	const auto time_solved_done = std::chrono::system_clock::now();
 
 	// calculate durations
@@ -48,14 +125,7 @@ auto check_all_nary_on_domain(size_t n, size_t domain_size, cspc::polymorphism_c
 		duration_to_precise_ms(time_solved_done - time_relations_done);
 	const auto time_elapsed_total_ms = duration_to_precise_ms(time_solved_done - time_before);
 
-	// print results
-	spdlog::info("Results:");
-	spdlog::info("{:<10} │ {}", "Class", "cspc::relation");
-	spdlog::info("───────────┼─────────");
-	std::ranges::for_each(std::views::iota(0u, satisfiability.size()), [&](size_t i) {
-		const auto label = satisfiability[i] == cspc::SATISFIABLE ? "P" : "NP-hard";
-		spdlog::info("{:<10} │ {}", label, relations[i]);
-	});
+	print_results(relations, satisfiability);
 
 	// print time profile
 	spdlog::info("");
@@ -66,4 +136,6 @@ auto check_all_nary_on_domain(size_t n, size_t domain_size, cspc::polymorphism_c
 	spdlog::info("{:<30} │ {:>10.2f}ms", "Constructing and solving SATs", time_elapsed_solve_ms);
 	spdlog::info("┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┄┼┄┄┄┄┄┄┄┄┄┄┄┄┄");
 	spdlog::info("{:<30} │ {:>10.2f}ms", "Total", time_elapsed_total_ms);
+
+	print_fast_path_statistics();
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <cspc/encodings/common.hpp>
+#include <filesystem>
 
 extern auto minizinc_siggers_checker() -> cspc::polymorphism_checker;
 extern auto encoding_siggers_checker() -> cspc::polymorphism_checker;
+extern auto print_results(
+	std::vector<cspc::relation> const& relations,
+	std::vector<cspc::satisfiability> const& satisfiability) -> void;
 extern auto check_single(cspc::relation const& relation, cspc::polymorphism_checker checker)
 	-> void;
-extern auto
-check_all_nary_on_domain(size_t n, size_t domain_size, cspc::polymorphism_checker checker) -> void;
\ No newline at end of file
+// with a journal path, finished relations are journaled and skipped when the run is restarted
+extern auto check_all_nary_on_domain(
+	size_t n,
+	size_t domain_size,
+	cspc::polymorphism_checker checker,
+	std::optional<std::filesystem::path> journal_path = std::nullopt) -> void;
\ No newline at end of file
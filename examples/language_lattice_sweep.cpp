@@ -0,0 +1,42 @@
+#include "common.hpp"
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/lattice.hpp>
+#include <spdlog/spdlog.h>
+
+// usage:
+//   language_lattice_sweep <arity> <domain size> <pool size>
+//     classifies every language made of the first <pool size> relations of all_nary_relations,
+//     solving as few of them as monotonicity allows
+auto main(int argc, char* argv[]) -> int {
+	if (argc != 4) {
+		spdlog::error("Incorrect number of arguments: expected arity, domain size and pool size");
+		return EXIT_FAILURE;
+	}
+	// throws
+	const auto n = std::stoul(argv[1]);
+	const auto d = std::stoul(argv[2]);
+	const auto pool_size = std::stoul(argv[3]);
+
+	if (n < 1 || d < 2 || pool_size > cspc::MAX_LATTICE_POOL_SIZE) {
+		spdlog::error(
+			"Arity must be >0, domain must be >1 and pool size at most {}",
+			cspc::MAX_LATTICE_POOL_SIZE);
+		return EXIT_FAILURE;
+	}
+
+	auto pool = cspc::all_nary_relations(n, d);
+	pool.resize(std::min(pool.size(), pool_size));
+	const auto checker = cspc::create_language_encoding_solver(
+		cspc::siggers_operation(), d, cspc::multivalued_direct_encoding,
+		cspc::kissat_is_satisfiable);
+	const auto sweep = cspc::sweep_language_lattice(pool, checker);
+
+	const auto n_satisfiable = std::ranges::count(
+		sweep.results, cspc::SATISFIABLE, &cspc::lattice_result::result);
+	spdlog::info(
+		"{} languages, {} satisfiable: {} solved, {} inferred", sweep.results.size(),
+		n_satisfiable, sweep.n_solved, sweep.n_inferred);
+	return EXIT_SUCCESS;
+}
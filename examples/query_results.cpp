@@ -0,0 +1,98 @@
+#include "common.hpp"
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/results.hpp>
+#include <spdlog/spdlog.h>
+
+namespace {
+auto class_name(cspc::relation_class classification) -> std::string_view {
+	switch (classification) {
+	case cspc::POLYNOMIAL:
+		return "P";
+	case cspc::NP_HARD:
+		return "NP-hard";
+	default:
+		return "unknown";
+	}
+}
+
+auto sweep(size_t n, size_t d, std::filesystem::path const& path) -> bool {
+	const auto relations = cspc::all_nary_relations(n, d);
+	const auto store =
+		std::shared_ptr<cspc::result_store>(cspc::result_store::create(path, relations.size()));
+	if (store == nullptr) {
+		return false;
+	}
+	const auto checker = cspc::create_recording_checker(
+		cspc::default_fast_path_rules(), cspc::multivalued_direct_encoding,
+		cspc::kissat_is_satisfiable, store);
+	for (auto i = size_t(0); i < relations.size(); ++i) {
+		checker(i, relations[i]);
+	}
+	return true;
+}
+} // namespace
+
+// usage:
+//   query_results --sweep <arity> <domain size> <path>
+//     classifies every relation of all_nary_relations into a result store
+//   query_results <path>
+//     prints class counts and solve time percentiles of a result store
+//   query_results <path> <index>
+//     prints the record of a single relation
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv, argv + argc);
+	if (argc == 5 && args[1] == "--sweep") {
+		// throws
+		const auto n = std::stoul(args[2]);
+		const auto d = std::stoul(args[3]);
+		if (n < 2 || d < 2) {
+			spdlog::error("Arity and domain must be >1");
+			return EXIT_FAILURE;
+		}
+		return sweep(n, d, args[4]) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (argc != 2 && argc != 3) {
+		spdlog::error("Incorrect number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	const auto store = cspc::result_store::open(args[1]);
+	if (store == nullptr) {
+		return EXIT_FAILURE;
+	}
+
+	if (argc == 3) {
+		// throws
+		const auto index = std::stoul(args[2]);
+		if (index >= store->size()) {
+			spdlog::error("Index {} is out of range, the store has {} records", index, store->size());
+			return EXIT_FAILURE;
+		}
+		const auto record = store->get(index);
+		spdlog::info(
+			"Relation {}: {}, {} clauses, solved in {:.3f}ms{}", index,
+			class_name(record.classification), record.n_clauses, record.solve_time_ns / 1e6,
+			record.fast_path_rule.has_value()
+				? fmt::format(" by fast path rule {}", record.fast_path_rule.value())
+				: std::string{});
+		return EXIT_SUCCESS;
+	}
+
+	const auto summary = cspc::summarize_results(*store, 0, store->size());
+	spdlog::info(
+		"{} relations: {} P, {} NP-hard, {} unknown", store->size(),
+		summary.class_counts[cspc::POLYNOMIAL], summary.class_counts[cspc::NP_HARD],
+		summary.class_counts[cspc::UNKNOWN_CLASS]);
+	for (auto rule = size_t(0); rule < summary.fast_path_counts.size(); ++rule) {
+		spdlog::info("Fast path rule {} decided {}", rule, summary.fast_path_counts[rule]);
+	}
+	spdlog::info(
+		"Solve time {:.3f}s in total, p50 {:.3f}ms, p90 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms",
+		summary.total_solve_time_ns / 1e9, summary.solve_time_p50_ns / 1e6,
+		summary.solve_time_p90_ns / 1e6, summary.solve_time_p99_ns / 1e6,
+		summary.solve_time_max_ns / 1e6);
+	spdlog::info("{} clauses in total", summary.total_clauses);
+	return EXIT_SUCCESS;
+}
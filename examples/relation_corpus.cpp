@@ -0,0 +1,48 @@
+#include "common.hpp"
+#include <cspc/algorithms.hpp>
+#include <cspc/corpus.hpp>
+#include <spdlog/spdlog.h>
+
+// usage:
+//   relation_corpus --write <arity> <domain size> <path>
+//     writes every relation of all_nary_relations to a corpus
+//   relation_corpus <path> <first> <last>
+//     classifies relations [first, last) of a corpus
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv, argv + argc);
+	if (argc != 5 && argc != 4) {
+		spdlog::error("Incorrect number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	if (args[1] == "--write") {
+		// throws
+		const auto n = std::stoul(args[2]);
+		const auto d = std::stoul(args[3]);
+		if (n < 2 || d < 2) {
+			spdlog::error("Arity and domain must be >1");
+			return EXIT_FAILURE;
+		}
+		return cspc::write_relation_corpus(args[4], n, d, cspc::all_nary_relations(n, d))
+				   ? EXIT_SUCCESS
+				   : EXIT_FAILURE;
+	}
+
+	const auto corpus = cspc::relation_corpus::open(args[1]);
+	if (corpus == nullptr) {
+		return EXIT_FAILURE;
+	}
+	// throws
+	const auto first = std::min(std::stoul(args[2]), corpus->size());
+	const auto last = std::clamp(std::stoul(args[3]), first, corpus->size());
+
+	const auto checker = encoding_siggers_checker();
+	auto relations = std::vector<cspc::relation>{};
+	auto satisfiability = std::vector<cspc::satisfiability>{};
+	for (auto i = first; i < last; ++i) {
+		relations.push_back((*corpus)[i].to_relation());
+		satisfiability.push_back(checker(relations.back()));
+	}
+	print_results(relations, satisfiability);
+	return EXIT_SUCCESS;
+}
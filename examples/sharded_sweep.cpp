@@ -0,0 +1,64 @@
+#include "common.hpp"
+#include <cspc/algorithms.hpp>
+#include <cspc/sweep.hpp>
+#include <spdlog/spdlog.h>
+
+// usage:
+//   sharded_sweep <arity> <domain size> <shards> <workers> <directory>
+//     classifies every relation, running the shards in local worker processes
+//   sharded_sweep --worker <arity> <domain size> <shards> <shard> <directory>
+//     classifies a single shard, e.g. on another host sharing the directory
+//   sharded_sweep --merge <arity> <domain size> <shards> <directory>
+//     prints the merged results of finished shards
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv, argv + argc);
+	const auto mode = argc > 1 && args[1].starts_with("--") ? args[1] : std::string{};
+	const auto offset = mode.empty() ? 1 : 2;
+	const auto n_expected_arguments = mode == "--merge" ? 4 : 5;
+	if (argc != offset + n_expected_arguments) {
+		spdlog::error("Incorrect number of arguments");
+		return EXIT_FAILURE;
+	}
+	// throws
+	const auto n = std::stoul(args[offset]);
+	const auto d = std::stoul(args[offset + 1]);
+	const auto n_shards = std::stoul(args[offset + 2]);
+	const auto directory = std::filesystem::path(args[offset + n_expected_arguments - 1]);
+
+	if (n < 2 || d < 2 || n_shards < 1) {
+		spdlog::error("Arity and domain must be >1 and there must be at least one shard");
+		return EXIT_FAILURE;
+	}
+
+	const auto relations = cspc::all_nary_relations(n, d);
+
+	if (mode == "--worker") {
+		const auto shard_index = std::stoul(args[offset + 3]);
+		const auto shard = cspc::shard_range(relations.size(), shard_index, n_shards);
+		return cspc::run_shard(relations, shard, encoding_siggers_checker(), directory)
+				   ? EXIT_SUCCESS
+				   : EXIT_FAILURE;
+	}
+
+	if (mode.empty()) {
+		const auto n_workers = std::stoul(args[offset + 3]);
+		std::filesystem::create_directories(directory);
+		const auto worker_command = [&](size_t shard_index) {
+			return std::vector<std::string>{
+				args[0],	   "--worker",	  args[offset],	 args[offset + 1], args[offset + 2],
+				std::to_string(shard_index), directory.string()};
+		};
+		const auto options = cspc::supervisor_options{.n_workers = n_workers, .max_restarts = 3};
+		if (!cspc::supervise_shards(n_shards, directory, worker_command, options)) {
+			spdlog::error("Not every shard finished");
+			return EXIT_FAILURE;
+		}
+	}
+
+	const auto maybe_results = cspc::merge_shard_results(directory, n_shards, relations.size());
+	if (!maybe_results.has_value()) {
+		return EXIT_FAILURE;
+	}
+	print_results(relations, maybe_results.value());
+	return EXIT_SUCCESS;
+}
@@ -16,6 +16,7 @@ auto main(int argc, char* argv[]) -> int {
 		return EXIT_SUCCESS;
 	}
 
-	check_all_nary_on_domain(n, d, encoding_siggers_checker());
+	check_all_nary_on_domain(
+		n, d, encoding_siggers_checker(), fmt::format("output/journal_{}_{}.txt", n, d));
 	return EXIT_SUCCESS;
 }
@@ -1,13 +1,12 @@
 #pragma once
 
+#include "progress.hpp"
 #include "types.hpp"
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <numeric>
 #include <optional>
-#include <spdlog/pattern_formatter.h>
-#include <spdlog/sinks/ansicolor_sink.h>
-#include <spdlog/spdlog.h>
 #include <vector>
 
 namespace gautil {
@@ -31,6 +30,7 @@ auto all_subsets(InputRange&& in)
 	return result;
 }
 
+// std::ranges::transform, reporting progress and the time of every call to op
 template <
 	std::ranges::input_range Range,
 	std::weakly_incrementable OutputIterator,
@@ -44,26 +44,14 @@ template <
 auto transform_and_print_progress(Range&& range, OutputIterator result, Function op, Proj proj = {})
 	-> std::ranges::
 		unary_transform_result<std::ranges::borrowed_iterator_t<Range>, OutputIterator> {
-	// setup logger
-	constexpr auto PROGRESS_BAR_LENGTH = uint32_t{20};
-	const auto console_sink = std::make_shared<spdlog::sinks::ansicolor_stdout_sink_mt>();
-	auto carriage_return_logger = spdlog::logger("logger", {console_sink});
-	carriage_return_logger.set_formatter(std::make_unique<spdlog::pattern_formatter>(
-		"[%Y-%m-%d %H:%M:%S.%e] [%l] %v", spdlog::pattern_time_type::local, std::string("\r")));
-
 	const auto distance = std::ranges::distance(range);
 	auto input = std::ranges::begin(range);
-	carriage_return_logger.info("[{}]", std::string(PROGRESS_BAR_LENGTH, ' '));
-	for (auto i = 0u; i < distance; ++i) {
+	auto progress = progress_tracker(distance);
+	for (auto i = decltype(distance)(0); i < distance; ++i) {
+		const auto time_before = std::chrono::steady_clock::now();
 		*result++ = std::invoke(op, std::invoke(proj, *input++));
-		const auto filled = float(i) / distance;
-		const auto unfilled = float(1.0) - filled;
-		carriage_return_logger.info(
-			"[{}{}] {:.2f}%", std::string(filled * PROGRESS_BAR_LENGTH, '='),
-			std::string(unfilled * PROGRESS_BAR_LENGTH, ' '), filled * 100.0);
+		progress.record(std::chrono::steady_clock::now() - time_before);
 	}
-	carriage_return_logger.info("[{}] 100.00%\n", std::string(PROGRESS_BAR_LENGTH, '='));
-
 	return {input, result};
 }
 
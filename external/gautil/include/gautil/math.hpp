@@ -11,4 +11,10 @@ template <u64 base> constexpr auto comptime_pow<base, 0> = 1;
 extern auto n_choose_k(u64 n, u64 k) -> u64;
 extern auto repeat(size_t n, std::function<void(void)> fn) -> void;
 extern auto round_up_to_power_of_2(u64 v) -> u64;
+
+// buckets of a log-linear histogram: values below 8 get a bucket each and larger values four
+// buckets per power of two, which bounds the relative error of a bucket's midpoint by 12.5%
+constexpr auto N_LOG_LINEAR_BUCKETS = size_t{256};
+extern auto log_linear_bucket(u64 value) -> size_t;
+extern auto log_linear_bucket_value(size_t bucket) -> u64;
 } // namespace gautil
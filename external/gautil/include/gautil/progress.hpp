@@ -0,0 +1,52 @@
+#pragma once
+
+#include "math.hpp"
+#include "types.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <spdlog/logger.h>
+#include <thread>
+
+namespace gautil {
+// counts finished items from any number of threads and redraws a progress line with throughput,
+// the distribution of item times and an ETA from a background thread; recording an item is two
+// relaxed atomic increments, so it is cheap enough to call per item even for microsecond items
+class progress_tracker {
+  public:
+	explicit progress_tracker(
+		u64 n_items,
+		std::chrono::milliseconds redraw_interval = std::chrono::milliseconds(250));
+	progress_tracker(progress_tracker const&) = delete;
+	auto operator=(progress_tracker const&) -> progress_tracker& = delete;
+	// stops the redraw thread and draws the final line
+	~progress_tracker();
+
+	auto record(std::chrono::nanoseconds item_time) -> void;
+	// items finished without being timed, e.g. restored from a checkpoint
+	auto skip(u64 n_items) -> void;
+	auto completed() const -> u64;
+
+  private:
+	// a log-linear histogram of item times in nanoseconds
+	static constexpr auto N_TIME_BUCKETS = N_LOG_LINEAR_BUCKETS;
+
+	auto redraw_loop(std::stop_token stop) -> void;
+	auto draw(bool final) -> void;
+	auto time_quantile(std::array<u64, N_TIME_BUCKETS> const& counts, u64 n_timed, double q) const
+		-> std::chrono::nanoseconds;
+
+	const u64 m_n_items;
+	const std::chrono::milliseconds m_redraw_interval;
+	const std::chrono::steady_clock::time_point m_start;
+	std::unique_ptr<spdlog::logger> m_logger;
+	std::atomic<u64> m_completed{0};
+	std::atomic<u64> m_skipped{0};
+	std::array<std::atomic<u64>, N_TIME_BUCKETS> m_time_buckets{};
+	std::mutex m_mutex;
+	std::condition_variable_any m_wake;
+	std::jthread m_redraw_thread;
+};
+} // namespace gautil
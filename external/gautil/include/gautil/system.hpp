@@ -1,9 +1,30 @@
 #pragma once
 
+#include <filesystem>
 #include <optional>
 #include <string>
+#include <sys/types.h>
+#include <vector>
 
 namespace gautil {
 extern auto call(std::string const& command, std::string const& input = "")
 	-> std::optional<std::string>;
-}
+
+struct process_exit {
+	pid_t pid;
+	bool success; // exited normally with status 0
+};
+
+// starts a child process running arguments[0] with the given arguments, searching PATH
+extern auto spawn(std::vector<std::string> const& arguments) -> std::optional<pid_t>;
+// blocks until one of the given child processes exits; other children are left to whoever
+// spawned them, so they are polled rather than waited for with waitpid(-1, ...)
+extern auto wait_for_any_of(std::vector<pid_t> const& pids) -> std::optional<process_exit>;
+
+// a stream socket bound to `path` and listening, replacing a socket file left behind by a
+// process that was killed
+extern auto listen_unix_socket(std::filesystem::path const& path) -> std::optional<int>;
+extern auto connect_unix_socket(std::filesystem::path const& path) -> std::optional<int>;
+// false if the peer went away before everything was sent
+extern auto send_all(int fd, void const* data, size_t size) -> bool;
+} // namespace gautil
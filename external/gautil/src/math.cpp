@@ -1,5 +1,7 @@
 #include "gautil/math.hpp"
 
+#include <bit>
+
 namespace gautil {
 auto n_choose_k(u64 n, u64 k) -> u64 {
 	if (k == 0) {
@@ -19,4 +21,22 @@ auto round_up_to_power_of_2(u64 v) -> u64 {
 	v |= v >> 32;
 	return v++;
 }
-} // namespace gautil
\ No newline at end of file
+
+auto log_linear_bucket(u64 value) -> size_t {
+	if (value < 8) {
+		return value;
+	}
+	const auto width = size_t(std::bit_width(value));
+	return 8 + (width - 4) * 4 + ((value >> (width - 3)) & 3);
+}
+
+// the midpoint of the values falling into a bucket
+auto log_linear_bucket_value(size_t bucket) -> u64 {
+	if (bucket < 8) {
+		return bucket;
+	}
+	const auto width = (bucket - 8) / 4 + 4;
+	const auto sub = (bucket - 8) % 4;
+	return ((4 + sub) << (width - 3)) + (u64(1) << (width - 3)) / 2;
+}
+} // namespace gautil
@@ -0,0 +1,132 @@
+#include "gautil/progress.hpp"
+
+#include "gautil/math.hpp"
+
+#include <fmt/format.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/ansicolor_sink.h>
+
+namespace gautil {
+namespace __internal {
+auto format_duration(std::chrono::nanoseconds duration) -> std::string {
+	const auto ns = double(duration.count());
+	if (ns < 1e3) {
+		return fmt::format("{:.0f}ns", ns);
+	}
+	if (ns < 1e6) {
+		return fmt::format("{:.1f}µs", ns / 1e3);
+	}
+	if (ns < 1e9) {
+		return fmt::format("{:.1f}ms", ns / 1e6);
+	}
+	const auto s = u64(ns / 1e9);
+	if (s < 60) {
+		return fmt::format("{:.1f}s", ns / 1e9);
+	}
+	if (s < 3600) {
+		return fmt::format("{}m{:02}s", s / 60, s % 60);
+	}
+	return fmt::format("{}h{:02}m", s / 3600, s / 60 % 60);
+}
+} // namespace __internal
+
+progress_tracker::progress_tracker(u64 n_items, std::chrono::milliseconds redraw_interval)
+	: m_n_items{n_items}, m_redraw_interval{redraw_interval},
+	  m_start{std::chrono::steady_clock::now()} {
+	// the logger is built once; every line starts with a carriage return to overwrite the last
+	const auto console_sink = std::make_shared<spdlog::sinks::ansicolor_stdout_sink_mt>();
+	m_logger = std::make_unique<spdlog::logger>("progress", console_sink);
+	m_logger->set_formatter(std::make_unique<spdlog::pattern_formatter>(
+		"[%Y-%m-%d %H:%M:%S.%e] [%l] %v", spdlog::pattern_time_type::local, std::string("\r")));
+	m_redraw_thread = std::jthread([this](std::stop_token stop) { redraw_loop(stop); });
+}
+
+progress_tracker::~progress_tracker() {
+	m_redraw_thread.request_stop();
+	m_redraw_thread.join();
+	draw(true);
+}
+
+auto progress_tracker::record(std::chrono::nanoseconds item_time) -> void {
+	const auto bucket = log_linear_bucket(u64(std::max(item_time.count(), i64(0))));
+	m_time_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m_completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto progress_tracker::skip(u64 n_items) -> void {
+	m_skipped.fetch_add(n_items, std::memory_order_relaxed);
+	m_completed.fetch_add(n_items, std::memory_order_relaxed);
+}
+
+auto progress_tracker::completed() const -> u64 {
+	return m_completed.load(std::memory_order_relaxed);
+}
+
+auto progress_tracker::redraw_loop(std::stop_token stop) -> void {
+	auto lock = std::unique_lock(m_mutex);
+	// sleeps for the redraw interval but wakes immediately when the tracker is destroyed
+	const auto stopped = [&] { return stop.stop_requested(); };
+	while (!m_wake.wait_for(lock, stop, m_redraw_interval, stopped)) {
+		draw(false);
+	}
+}
+
+auto progress_tracker::time_quantile(
+	std::array<u64, N_TIME_BUCKETS> const& counts, u64 n_timed, double q) const
+	-> std::chrono::nanoseconds {
+	const auto target = u64(q * double(n_timed));
+	auto seen = u64{0};
+	for (auto b = size_t(0); b < N_TIME_BUCKETS; ++b) {
+		seen += counts[b];
+		if (counts[b] > 0 && seen >= std::max(target, u64(1))) {
+			return std::chrono::nanoseconds(i64(log_linear_bucket_value(b)));
+		}
+	}
+	return std::chrono::nanoseconds(0);
+}
+
+auto progress_tracker::draw(bool final) -> void {
+	constexpr auto PROGRESS_BAR_LENGTH = u64{20};
+
+	const auto completed = std::min(m_completed.load(std::memory_order_relaxed), m_n_items);
+	const auto skipped = m_skipped.load(std::memory_order_relaxed);
+	auto counts = std::array<u64, N_TIME_BUCKETS>{};
+	auto n_timed = u64{0};
+	for (auto b = size_t(0); b < N_TIME_BUCKETS; ++b) {
+		counts[b] = m_time_buckets[b].load(std::memory_order_relaxed);
+		n_timed += counts[b];
+	}
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start);
+	const auto items_per_second = elapsed.count() > 0 ? double(n_timed) / elapsed.count() : 0.0;
+	const auto filled = m_n_items > 0 ? double(completed) / double(m_n_items) : 1.0;
+	const auto bar_filled = u64(filled * PROGRESS_BAR_LENGTH);
+	const auto eta = items_per_second > 0
+						 ? __internal::format_duration(std::chrono::nanoseconds(
+							   i64(double(m_n_items - completed) / items_per_second * 1e9)))
+						 : std::string("?");
+
+	auto line = fmt::format(
+		"[{}{}] {:.2f}% {}/{}", std::string(bar_filled, '='),
+		std::string(PROGRESS_BAR_LENGTH - bar_filled, ' '), filled * 100.0, completed, m_n_items);
+	if (skipped > 0) {
+		line += fmt::format(" ({} skipped)", skipped);
+	}
+	line += fmt::format(" | {:.1f} items/s", items_per_second);
+	if (n_timed > 0) {
+		line += fmt::format(
+			" | p50 {} p90 {} max {}",
+			__internal::format_duration(time_quantile(counts, n_timed, 0.5)),
+			__internal::format_duration(time_quantile(counts, n_timed, 0.9)),
+			__internal::format_duration(time_quantile(counts, n_timed, 1.0)));
+	}
+	if (final) {
+		line += fmt::format(
+			" | took {}\n", __internal::format_duration(
+								std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)));
+	} else {
+		line += fmt::format(" | ETA {}", eta);
+	}
+	m_logger->info(line);
+}
+} // namespace gautil
@@ -1,11 +1,33 @@
 #include "gautil/system.hpp"
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
 
 namespace gautil {
+namespace __internal {
+// how long wait_for_any_of sleeps between polling its children
+constexpr auto CHILD_POLL_INTERVAL = std::chrono::milliseconds{10};
+
+auto unix_socket_address(std::filesystem::path const& path) -> std::optional<sockaddr_un> {
+	auto address = sockaddr_un{};
+	address.sun_family = AF_UNIX;
+	if (path.native().size() >= sizeof(address.sun_path)) {
+		spdlog::error("Socket path {} is too long", path.string());
+		return std::nullopt;
+	}
+	std::ranges::copy(path.native(), address.sun_path);
+	return address;
+}
+} // namespace __internal
+
 auto call(std::string const& command, std::string const& input) -> std::optional<std::string> {
 	const auto process =
 		std::unique_ptr<FILE, decltype(&pclose)>(popen(command.data(), "r"), pclose);
@@ -23,4 +45,106 @@ auto call(std::string const& command, std::string const& input) -> std::optional
 	}
 	return result;
 }
+
+auto spawn(std::vector<std::string> const& arguments) -> std::optional<pid_t> {
+	auto argv = std::vector<char*>{};
+	argv.reserve(arguments.size() + 1);
+	for (auto const& argument : arguments) {
+		argv.push_back(const_cast<char*>(argument.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	const auto pid = fork();
+	if (pid < 0) {
+		spdlog::error("Failed to call fork() with error: {}", strerror(errno));
+		return std::nullopt;
+	}
+	if (pid == 0) {
+		execvp(argv[0], argv.data());
+		// only reached if exec failed
+		_exit(127);
+	}
+	return pid;
+}
+
+auto wait_for_any_of(std::vector<pid_t> const& pids) -> std::optional<process_exit> {
+	if (pids.empty()) {
+		return std::nullopt;
+	}
+	while (true) {
+		for (const auto pid : pids) {
+			auto status = int{0};
+			const auto result = waitpid(pid, &status, WNOHANG);
+			if (result < 0) {
+				spdlog::error("Failed to call waitpid({}) with error: {}", pid, strerror(errno));
+				return std::nullopt;
+			}
+			if (result == pid) {
+				return process_exit{
+					.pid = pid,
+					.success = WIFEXITED(status) && WEXITSTATUS(status) == 0,
+				};
+			}
+		}
+		std::this_thread::sleep_for(__internal::CHILD_POLL_INTERVAL);
+	}
+}
+
+auto listen_unix_socket(std::filesystem::path const& path) -> std::optional<int> {
+	const auto address = __internal::unix_socket_address(path);
+	if (!address.has_value()) {
+		return std::nullopt;
+	}
+	const auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		spdlog::error("Failed to create a socket: {}", strerror(errno));
+		return std::nullopt;
+	}
+	// a stale socket file would make bind fail
+	auto error = std::error_code{};
+	std::filesystem::remove(path, error);
+	if (::bind(fd, reinterpret_cast<sockaddr const*>(&address.value()), sizeof(sockaddr_un)) !=
+			0 ||
+		::listen(fd, SOMAXCONN) != 0) {
+		spdlog::error("Failed to listen on {}: {}", path.string(), strerror(errno));
+		::close(fd);
+		return std::nullopt;
+	}
+	return fd;
+}
+
+auto connect_unix_socket(std::filesystem::path const& path) -> std::optional<int> {
+	const auto address = __internal::unix_socket_address(path);
+	if (!address.has_value()) {
+		return std::nullopt;
+	}
+	const auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 ||
+		::connect(fd, reinterpret_cast<sockaddr const*>(&address.value()), sizeof(sockaddr_un)) !=
+			0) {
+		spdlog::error("Failed to connect to {}: {}", path.string(), strerror(errno));
+		if (fd >= 0) {
+			::close(fd);
+		}
+		return std::nullopt;
+	}
+	return fd;
+}
+
+auto send_all(int fd, void const* data, size_t size) -> bool {
+	const auto* bytes = static_cast<char const*>(data);
+	while (size > 0) {
+		// a peer that went away must not kill the process with SIGPIPE
+		const auto n_sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+		if (n_sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n_sent <= 0) {
+			return false;
+		}
+		bytes += n_sent;
+		size -= size_t(n_sent);
+	}
+	return true;
+}
 } // namespace gautil
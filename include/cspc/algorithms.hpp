@@ -22,15 +22,34 @@ extern auto apply_identity(
 	relation_entry const& input,
 	std::vector<domain_value> const& from,
 	std::vector<domain_value> const& to) -> relation_entry;
+extern auto find_relation_domain_size(relation const& _relation) -> size_t;
+extern auto find_language_domain_size(constraint_language const& language) -> size_t;
+extern auto construct_operation_identity_constraints(operation const& _operation, size_t domain_size)
+	-> std::vector<constraint>;
+extern auto construct_is_polymorphism_constraints(
+	relation const& _relation, size_t domain_size, size_t operation_arity)
+	-> std::vector<constraint>;
 } // namespace __internal
 
 extern auto neq_relation(size_t arity, size_t domain_size) -> relation;
 extern auto eq_relation(size_t arity, size_t domain_size) -> relation;
 extern auto all_nary_relations(size_t n, size_t domain_size) -> std::vector<relation>;
+// the relations of all_nary_relations in a Gray code order, where neighbors differ by one tuple
+extern auto gray_code_nary_relations(size_t n, size_t domain_size) -> std::vector<relation>;
 extern auto inverse(constraint const& _constraint, size_t domain_size) -> constraint;
 extern auto siggers_operation() -> operation;
-extern auto
-construct_preserves_operation_csp(operation const& _operation, relation const& _relation) -> csp;
+extern auto majority_operation() -> operation;
+extern auto maltsev_operation() -> operation;
+// of positive arity
+extern auto cyclic_operation(size_t arity) -> operation;
+// with n_threads > 1 the identity and polymorphism constraints are built on that many threads, in
+// the same order as the serial construction
+extern auto construct_preserves_operation_csp(
+	operation const& _operation, relation const& _relation, size_t n_threads = 1) -> csp;
+// one function table shared by the polymorphism constraints of every relation of the language
+extern auto construct_preserves_operation_csp(
+	operation const& _operation, constraint_language const& language, size_t n_threads = 1)
+	-> csp;
 extern auto inverse(constraint const& _constraint, size_t domain_size) -> constraint;
 extern auto create_all_tuples(size_t arity, size_t domain_size) -> std::vector<relation_entry>;
 
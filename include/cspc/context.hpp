@@ -0,0 +1,38 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <memory>
+
+namespace cspc {
+// reusable scratch space for classifying relations against one operation; the meta-CSP is
+// written straight into flat clause buffers that are cleared rather than freed between
+// relations, so once they have grown to fit the largest relation classification allocates
+// nothing outside of the solver. A context is not thread safe, keep one per worker thread
+class classification_context {
+  public:
+	// `_encoding` encodes the identity constraints and must be one of the direct encodings, whose
+	// conflict clauses the polymorphism constraints are written as
+	classification_context(operation const& _operation, encoding _encoding);
+
+	// the encoded meta-CSP of the relation, valid until the next call
+	auto encode(relation const& _relation) -> flat_clauses;
+	auto classify(relation const& _relation, flat_solver const& _solver) -> satisfiability;
+
+  private:
+	auto identity_clauses(size_t domain_size) -> std::vector<i32> const&;
+
+	operation m_operation;
+	encoding m_encoding;
+	// the encoded identity constraints, indexed by domain size
+	std::vector<std::optional<std::vector<i32>>> m_identity_clauses;
+	std::vector<i32> m_clauses;
+	std::vector<u8> m_contains;
+	std::vector<size_t> m_choice;
+	std::vector<variable> m_scope;
+};
+
+// classifies with a classification context owned by the checker; create one checker per thread
+extern auto create_context_solver(
+	operation const& _operation, encoding _encoding, flat_solver _solver) -> polymorphism_checker;
+} // namespace cspc
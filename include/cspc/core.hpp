@@ -0,0 +1,59 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cspc {
+namespace __internal {
+// a map of the domain into itself avoiding `excluded` under which the image of every tuple of
+// the relation is in the relation, if there is one
+extern auto find_endomorphism_avoiding(
+	relation const& _relation, size_t domain_size, domain_value excluded)
+	-> std::optional<std::vector<domain_value>>;
+} // namespace __internal
+
+// the image of the relation under endomorphisms until none is left that is not surjective, with
+// the remaining values renumbered from 0 in order; a relation has a polymorphism satisfying
+// identities without variables exactly when its core does
+extern auto find_core(relation const& _relation) -> relation;
+
+// the meta-CSP of a core, restricted to idempotent operations: if a core has an operation
+// satisfying identities without variables, it has an idempotent one, since f(x, ..., x) is an
+// automorphism that can be undone
+extern auto construct_idempotent_preserves_operation_csp(
+	operation const& _operation, relation const& core) -> csp;
+
+// the cores of the most recently used relations, most recently used first
+class core_cache {
+  public:
+	core_cache(size_t capacity) : m_capacity{capacity} {}
+
+	auto find(relation const& _relation) -> relation;
+	auto hits() const -> size_t { return m_hits.load(std::memory_order_relaxed); }
+	auto misses() const -> size_t { return m_misses.load(std::memory_order_relaxed); }
+
+  private:
+	using entry = std::pair<relation, relation>; // a relation and its core
+
+	std::mutex m_mutex;
+	std::list<entry> m_cores;
+	std::unordered_map<relation, std::list<entry>::iterator> m_positions;
+	size_t m_capacity;
+	std::atomic<size_t> m_hits{0};
+	std::atomic<size_t> m_misses{0};
+};
+
+// solves the idempotent meta-CSP of the relation's core; operations with identities binding
+// variables, such as a majority operation, are not preserved under taking cores, so their
+// relations are checked as they are
+extern auto create_core_encoding_solver(
+	operation const& _operation,
+	encoding _encoding,
+	solver _solver,
+	std::shared_ptr<core_cache> cache) -> polymorphism_checker;
+} // namespace cspc
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include <filesystem>
+#include <memory>
+
+namespace cspc {
+// A relation corpus is a binary file of relations sharing an arity and domain, laid out as
+//   0   "CSPCREL1", u32 version, u32 arity, u32 domain size, u32 bits per tuple,
+//       u64 number of relations, u64 byte position of the offset index, zero padding up to 64
+//   64  the tuples of every relation, each packed into `bits per tuple` bits as its index in
+//       the order of index_to_function_input, in u64 words
+//   ... the offset index: u64 position of the first tuple of every relation, plus the total
+// All integers are little endian.
+
+// the tuples of one relation in a corpus, read in place
+class relation_view {
+  public:
+	relation_view(
+		u64 const* words,
+		u64 first_tuple,
+		u64 n_tuples,
+		u32 tuple_bits,
+		size_t arity,
+		size_t domain_size)
+		: m_words{words}, m_first_tuple{first_tuple}, m_n_tuples{n_tuples},
+		  m_tuple_bits{tuple_bits}, m_arity{arity}, m_domain_size{domain_size} {}
+
+	auto size() const -> size_t { return m_n_tuples; }
+	auto arity() const -> size_t { return m_arity; }
+	auto domain_size() const -> size_t { return m_domain_size; }
+	// the index of the i:th tuple in the order of index_to_function_input
+	auto tuple_index(size_t i) const -> u64 {
+		const auto bit = (m_first_tuple + i) * m_tuple_bits;
+		const auto word = bit / 64;
+		const auto shift = bit % 64;
+		auto value = m_words[word] >> shift;
+		if (shift + m_tuple_bits > 64) {
+			value |= m_words[word + 1] << (64 - shift);
+		}
+		return m_tuple_bits == 64 ? value : value & ((u64(1) << m_tuple_bits) - 1);
+	}
+	auto entry(size_t i) const -> relation_entry;
+	auto to_relation() const -> relation;
+
+  private:
+	u64 const* m_words;
+	u64 m_first_tuple;
+	u64 m_n_tuples;
+	u32 m_tuple_bits;
+	size_t m_arity;
+	size_t m_domain_size;
+};
+
+// a memory mapped corpus; opening it only validates the header and the offset index
+class relation_corpus {
+  public:
+	relation_corpus(relation_corpus const&) = delete;
+	auto operator=(relation_corpus const&) -> relation_corpus& = delete;
+	~relation_corpus();
+
+	static auto open(std::filesystem::path const& path) -> std::unique_ptr<relation_corpus>;
+
+	auto size() const -> size_t { return m_n_relations; }
+	auto arity() const -> size_t { return m_arity; }
+	auto domain_size() const -> size_t { return m_domain_size; }
+	auto operator[](size_t i) const -> relation_view {
+		return relation_view(
+			m_words, m_offsets[i], m_offsets[i + 1] - m_offsets[i], m_tuple_bits, m_arity,
+			m_domain_size);
+	}
+
+  private:
+	relation_corpus(void* mapping, size_t mapping_size)
+		: m_mapping{mapping}, m_mapping_size{mapping_size} {}
+
+	void* m_mapping;
+	size_t m_mapping_size;
+	size_t m_arity{0};
+	size_t m_domain_size{0};
+	u32 m_tuple_bits{0};
+	size_t m_n_relations{0};
+	u64 const* m_words{nullptr};
+	u64 const* m_offsets{nullptr};
+};
+
+extern auto write_relation_corpus(
+	std::filesystem::path const& path,
+	size_t arity,
+	size_t domain_size,
+	std::vector<relation> const& relations) -> bool;
+} // namespace cspc
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace cspc {
+// A client sends any number of requests over a Unix domain socket without waiting for answers:
+//   u32 request id, u32 arity, u32 number of tuples, then every tuple with one u8 per value
+// and receives one answer per request, in the order they are classified rather than sent:
+//   u32 request id, u8 1 if satisfiable, 0 if unsatisfiable, 0xff if the request was rejected
+// All integers are little endian.
+constexpr auto DAEMON_REJECTED = u8{0xff};
+
+struct daemon_options {
+	size_t n_threads;
+	// the most recently used relations whose results are kept, 0 disables the cache
+	size_t result_cache_capacity;
+	size_t max_request_size; // bytes of tuples in a single request
+};
+
+namespace __internal {
+class daemon_connection;
+
+struct daemon_job {
+	std::shared_ptr<daemon_connection> connection;
+	u32 id;
+	relation _relation;
+	std::string key; // the request as sent, for the result cache
+	std::chrono::steady_clock::time_point received;
+};
+
+// the thread reading a connection, joined once it is done so that short clients do not pile up
+struct daemon_reader {
+	std::weak_ptr<daemon_connection> connection;
+	std::unique_ptr<std::atomic<bool>> done;
+	std::jthread thread;
+};
+} // namespace __internal
+
+// serves classification requests from a pool of worker threads; `create_checker` is called once
+// per worker and the checkers, with every cache they hold, live as long as the daemon, so only
+// the first requests pay for building operations, identity clauses and nogood tables
+class classification_daemon {
+  public:
+	classification_daemon(
+		std::function<polymorphism_checker()> create_checker, daemon_options const& options);
+	classification_daemon(classification_daemon const&) = delete;
+	auto operator=(classification_daemon const&) -> classification_daemon& = delete;
+	~classification_daemon();
+
+	// binds the socket, replacing a stale one, and accepts connections on a background thread
+	auto listen(std::filesystem::path const& path) -> bool;
+	// closes the socket and every connection and joins all threads
+	auto stop() -> void;
+
+	auto n_requests() const -> size_t { return m_n_requests.load(std::memory_order_relaxed); }
+	auto n_cache_hits() const -> size_t { return m_n_cache_hits.load(std::memory_order_relaxed); }
+
+  private:
+	auto accept_loop(std::stop_token stop) -> void;
+	auto read_loop(std::shared_ptr<__internal::daemon_connection> connection) -> void;
+	auto work_loop(std::stop_token stop, polymorphism_checker checker) -> void;
+	auto find_cached(std::string const& key) -> std::optional<satisfiability>;
+	auto insert_cached(std::string key, satisfiability result) -> void;
+
+	daemon_options m_options;
+	std::filesystem::path m_path;
+	int m_listen_fd{-1};
+
+	std::mutex m_queue_mutex;
+	std::condition_variable_any m_queue_ready;
+	std::deque<__internal::daemon_job> m_queue;
+
+	using cache_entry = std::pair<std::string, satisfiability>;
+
+	std::mutex m_cache_mutex;
+	std::list<cache_entry> m_cache; // most recently used first
+	std::unordered_map<std::string_view, std::list<cache_entry>::iterator> m_cache_positions;
+
+	std::mutex m_readers_mutex;
+	std::vector<__internal::daemon_reader> m_readers;
+
+	std::atomic<size_t> m_n_requests{0};
+	std::atomic<size_t> m_n_cache_hits{0};
+	// shared by every daemon in the process
+	metric_counter& m_requests_metric;
+	metric_counter& m_cache_hits_metric;
+	metric_gauge& m_queue_depth_metric;
+	metric_histogram& m_latency_metric;
+	std::vector<std::jthread> m_workers;
+	std::jthread m_acceptor;
+};
+
+// sends every relation to a daemon at once and collects the answers in relation order, or
+// nothing if the daemon could not be reached or rejected a relation
+extern auto classify_remote(std::filesystem::path const& path, std::vector<relation> const& relations)
+	-> std::optional<std::vector<satisfiability>>;
+} // namespace cspc
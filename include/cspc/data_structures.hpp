@@ -1,11 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <compare>
 #include <functional>
 #include <gautil/types.hpp>
 #include <initializer_list>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -36,29 +38,12 @@ class relation_entry {
 	auto operator==(relation_entry const& other) const -> bool {
 		return m_length == other.m_length && m_data == other.m_data;
 	}
-	auto operator<(relation_entry const& other) const -> bool {
-		if (m_length < other.m_length) {
-			return true;
+	// shorter entries first, then lexicographically
+	auto operator<=>(relation_entry const& other) const -> std::strong_ordering {
+		if (const auto order = m_length <=> other.m_length; order != 0) {
+			return order;
 		}
-		if (m_length > other.m_length) {
-			return false;
-		}
-		for (auto i = 0u; i < other.size(); ++i) {
-			if (m_data[i] == other.m_data[i]) {
-				continue;
-			}
-			return m_data[i] < other.m_data[i];
-		}
-		return false;
-	}
-	auto operator>(relation_entry const& other) const -> bool {
-		return !(*this == other) && !(*this < other);
-	}
-	auto operator>=(relation_entry const& other) const -> bool {
-		return (*this == other) || (*this > other);
-	}
-	auto operator<=(relation_entry const& other) const -> bool {
-		return (*this == other) || (*this < other);
+		return m_data <=> other.m_data;
 	}
 
   private:
@@ -81,14 +66,60 @@ class relation {
 	auto begin() const { return m_data.begin(); }
 	auto end() const { return m_data.end(); }
 	auto data() const { return m_data; }
-	auto insert(relation_entry entry) -> void { m_data.push_back(entry); }
+	auto insert(relation_entry entry) -> void {
+		if (!m_sorted) {
+			m_data.push_back(entry);
+			return;
+		}
+		const auto it = std::ranges::lower_bound(m_data, entry);
+		if (it == m_data.end() || *it != entry) {
+			m_data.insert(it, std::move(entry));
+		}
+	}
 	auto reserve(size_t n) { m_data.reserve(n); }
 	auto size() const { return m_data.size(); }
 	auto empty() const -> bool { return m_data.empty(); }
-	auto erase(relation_entry const& value) {
-		// NOTE: relation would probably be better represented by an unordered_set, but there is no
-		// stdlib hash function for vectors
-		m_data.erase(std::ranges::find(m_data, value));
+	auto erase(relation_entry const& value) -> void {
+		const auto it = m_sorted ? std::ranges::lower_bound(m_data, value)
+								 : std::ranges::find(m_data, value);
+		if (it != m_data.end() && *it == value) {
+			m_data.erase(it);
+		}
+	}
+	// logarithmic once sorted, linear otherwise
+	auto contains(relation_entry const& value) const -> bool {
+		return m_sorted ? std::ranges::binary_search(m_data, value)
+						: std::ranges::find(m_data, value) != m_data.end();
+	}
+	// sorts the entries and drops duplicates; the relation then stays sorted as entries are
+	// inserted and erased
+	auto sort() -> void {
+		std::ranges::sort(m_data);
+		const auto [first, last] = std::ranges::unique(m_data);
+		m_data.erase(first, last);
+		m_sorted = true;
+	}
+	auto is_sorted() const -> bool { return m_sorted; }
+	// the entries in order without duplicates, as kept by a sorted relation
+	auto distinct_entries() const -> std::vector<relation_entry> {
+		if (m_sorted) {
+			return m_data;
+		}
+		auto entries = m_data;
+		std::ranges::sort(entries);
+		const auto [first, last] = std::ranges::unique(entries);
+		entries.erase(first, last);
+		return entries;
+	}
+	// as sets of entries, regardless of their order and of duplicates
+	auto operator==(relation const& other) const -> bool {
+		if (m_arity != other.m_arity) {
+			return false;
+		}
+		if (m_sorted && other.m_sorted) {
+			return m_data == other.m_data;
+		}
+		return distinct_entries() == other.distinct_entries();
 	}
 	auto operator[](size_t i) -> relation_entry& { return m_data[i]; };
 	auto operator[](size_t i) const -> relation_entry const& { return m_data[i]; };
@@ -96,13 +127,18 @@ class relation {
   private:
 	std::vector<relation_entry> m_data;
 	size_t m_arity;
+	bool m_sorted{false};
 };
 
+// relations of possibly different arities over one domain
+using constraint_language = std::vector<relation>;
+
 struct identity {
 	identity(
 		std::initializer_list<std::vector<variable>> inputs,
 		std::initializer_list<variable> variables = {})
 		: inputs{std::move(inputs)}, variables{std::move(variables)} {}
+	auto operator==(identity const& other) const -> bool = default;
 	const std::vector<std::vector<variable>> inputs{};
 	const std::vector<variable> variables{};
 };
@@ -110,6 +146,7 @@ struct identity {
 struct operation {
 	operation(size_t arity, std::initializer_list<identity> identities)
 		: arity{arity}, identities{std::move(identities)} {}
+	auto operator==(operation const& other) const -> bool = default;
 	const size_t arity;
 	const std::vector<identity> identities;
 };
@@ -163,6 +200,9 @@ class csp {
 			  return max_domain_size;
 		  }() + 1},
 		  m_constraints{std::move(constraints)} {}
+	// for csps that are parts of a larger csp, sharing its variables and domain
+	csp(std::vector<constraint> const& constraints, size_t n_variables, size_t domain_size)
+		: m_n_variables{n_variables}, m_domain_size{domain_size}, m_constraints{constraints} {}
 	csp(csp&& csp) = default;
 	csp(csp const& csp) = default;
 	auto operator=(csp const& other) -> csp& = default;
@@ -214,4 +254,47 @@ enum satisfiability {
 
 using solver = std::function<satisfiability(sat)>;
 
+// the truth value of every sat variable, zero-indexed
+using assignment = std::vector<bool>;
+
+// returned by solvers that also report a satisfying assignment, nothing if unsatisfiable
+using model_solver = std::function<std::optional<assignment>(sat)>;
+
+// clauses stored back to back as one-indexed literals, each clause terminated by a 0
+using flat_clauses = std::span<i32 const>;
+using flat_solver = std::function<satisfiability(flat_clauses)>;
+
+namespace __internal {
+// splitmix64's finalizer, so that sums of hashes stay spread out
+constexpr auto mix_hash(u64 hash) -> u64 {
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+	return hash ^ (hash >> 31);
+}
+} // namespace __internal
 } // namespace cspc
+
+template <> struct std::hash<cspc::relation_entry> {
+	auto operator()(cspc::relation_entry const& entry) const noexcept -> size_t {
+		auto hash = u64(entry.length());
+		for (const auto value : entry) {
+			hash = cspc::__internal::mix_hash(hash + value);
+		}
+		return hash;
+	}
+};
+
+// the sum of the hashes of the distinct entries, so that relations equal as sets hash alike
+template <> struct std::hash<cspc::relation> {
+	auto operator()(cspc::relation const& _relation) const noexcept -> size_t {
+		const auto add_entries = [](u64 hash, auto const& entries) {
+			for (auto const& entry : entries) {
+				hash += cspc::__internal::mix_hash(std::hash<cspc::relation_entry>{}(entry));
+			}
+			return hash;
+		};
+		const auto hash = cspc::__internal::mix_hash(_relation.arity());
+		return _relation.is_sorted() ? add_entries(hash, _relation)
+									 : add_entries(hash, _relation.distinct_entries());
+	}
+};
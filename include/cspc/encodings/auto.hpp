@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../data_structures.hpp"
+#include "common.hpp"
+
+namespace cspc {
+// linear model of the time it takes to encode and solve a sat instance
+struct encoding_cost_model {
+	f64 per_variable;
+	f64 per_clause;
+	f64 per_literal;
+	f64 per_relation_density;
+};
+
+struct encoding_candidate {
+	std::string name;
+	encoding encode;
+	std::function<encoding_statistics(csp const&)> statistics;
+	encoding_cost_model cost_model;
+};
+
+extern auto default_encoding_candidates() -> std::vector<encoding_candidate> const&;
+extern auto predicted_cost(encoding_statistics const& statistics, encoding_cost_model const& model)
+	-> f64;
+extern auto select_encoding(csp const& csp, std::vector<encoding_candidate> const& candidates)
+	-> encoding_candidate const&;
+extern auto create_auto_encoding(std::vector<encoding_candidate> candidates) -> encoding;
+extern auto auto_encoding(csp const& csp) -> sat;
+} // namespace cspc
@@ -1,8 +1,98 @@
 #pragma once
 
 #include "../data_structures.hpp"
+#include "common.hpp"
+#include <bit>
 
 namespace cspc {
+namespace __internal {
+// bits needed to represent every value of the domain
+extern auto n_bits(size_t domain_size) -> size_t;
+
+// a conjunction of bit literals: the bits in `mask` are fixed to those of `value`, the others are
+// free
+struct cube {
+	u32 mask;
+	u32 value;
+};
+
+enum minterm_status : u8 { MINTERM_OFF, MINTERM_ON, MINTERM_DC };
+
+// minimization is skipped above this many bits, where the truth table gets too large
+constexpr auto MAX_MINIMIZED_WIDTH = size_t{20};
+// exact prime implicants up to this many bits, expanded minterms above
+constexpr auto MAX_QUINE_MCCLUSKEY_WIDTH = size_t{10};
+
+// cubes covering every ON minterm of the truth table and no OFF minterm, DC minterms being free;
+// primes by Quine-McCluskey for small widths and by greedily expanding minterms otherwise, either
+// followed by removing redundant cubes
+extern auto minimize_cover(std::vector<minterm_status> const& truth_table, size_t width)
+	-> std::vector<cube>;
+
+// the forbidden tuples of a relation of at most MAX_MINIMIZED_WIDTH bits of the binary or log
+// encodings as cubes over the bits of its scope, where bit k of the j-th value is bit
+// j * n_bits + k; values outside the domain are forbidden too, or left free if other clauses
+// already prohibit them
+extern auto nogood_cubes(
+	relation const& _relation, size_t domain_size, size_t n_bits, bool out_of_domain_free)
+	-> std::vector<cube>;
+// the values of a log encoded variable outside the domain as cubes over its bits
+extern auto prohibited_value_cubes(size_t domain_size, size_t n_bits) -> std::vector<cube>;
+
+// a clause forbidding each cube on the bits of the scope
+template <std::output_iterator<clause> OutputIterator>
+auto create_cube_clauses(
+	std::span<cube const> cubes,
+	std::vector<variable> const& scope,
+	size_t n_bits,
+	OutputIterator result) -> OutputIterator {
+	for (auto const& _cube : cubes) {
+		auto _clause = clause{};
+		_clause.reserve(std::popcount(_cube.mask));
+		for (auto bit = size_t(0); bit < scope.size() * n_bits; ++bit) {
+			if ((_cube.mask >> bit & 1) == 0) {
+				continue;
+			}
+			const auto polarity = (_cube.value >> bit & 1) ? NEGATED : REGULAR;
+			_clause.push_back(literal(scope[bit / n_bits] * n_bits + bit % n_bits, polarity));
+		}
+		*result++ = std::move(_clause);
+	}
+	return result;
+}
+
+// a clause forbidding each tuple of the nogood relation on the bits of the scope, for relations
+// too wide to be minimized
+template <std::output_iterator<clause> OutputIterator>
+auto create_nogood_clauses(
+	relation const& nogoods,
+	std::vector<variable> const& scope,
+	size_t n_bits,
+	OutputIterator result) -> OutputIterator {
+	for (auto const& entry : nogoods) {
+		auto _clause = clause{};
+		_clause.reserve(scope.size() * n_bits);
+		for (auto j = size_t(0); j < scope.size(); ++j) {
+			for (auto k = size_t(0); k < n_bits; ++k) {
+				const auto polarity = (entry[j] >> k & 1) ? NEGATED : REGULAR;
+				_clause.push_back(literal(scope[j] * n_bits + k, polarity));
+			}
+		}
+		*result++ = std::move(_clause);
+	}
+	return result;
+}
+} // namespace __internal
+
+// both cover the forbidden tuples of each distinct relation with as few and as short clauses as
+// minimize_cover finds, and stamp them out on the scope of every constraint on that relation;
+// relations wider than MAX_MINIMIZED_WIDTH bits get a clause per forbidden tuple instead
 extern auto binary_encoding(csp const& csp) -> sat;
 extern auto log_encoding(csp const& csp) -> sat;
+// unlike the other statistics these minimize every relation not seen before; the cubes are kept
+// for later statistics and encodings, so ranking encodings first costs no second minimization
+extern auto binary_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto log_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto decode_binary_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value>;
 } // namespace cspc
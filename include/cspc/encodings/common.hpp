@@ -2,8 +2,18 @@
 
 #include "../algorithms.hpp"
 #include "../data_structures.hpp"
+#include "../metrics.hpp"
+#include <span>
 
 namespace cspc {
+// size of a sat instance as predicted from a csp, without emitting any clauses
+struct encoding_statistics {
+	size_t n_variables;
+	size_t n_clauses;
+	size_t n_literals;
+	f64 relation_density; // mean fraction of the domain tuples allowed by each constraint
+};
+
 namespace __internal {
 extern auto nogoods(std::vector<cspc::constraint> const& constraints, size_t domain_size)
 	-> std::vector<cspc::constraint>;
@@ -36,12 +46,64 @@ auto at_most_one_clauses(csp const& csp, OutputIterator result) -> OutputIterato
 	};
 	return result;
 }
+
+// appends the clauses of `part` to those of `shared`, where both encode parts of one csp; sat
+// variables from `first_auxiliary_variable` and up are renumbered to not collide
+extern auto combine_encoded(sat const& shared, sat const& part, variable first_auxiliary_variable)
+	-> sat;
+// orders clauses by their literals, for looking clauses up in a sorted range
+struct clause_less {
+	auto operator()(clause const& lhs, clause const& rhs) const -> bool {
+		return std::ranges::lexicographical_compare(lhs, rhs, {}, &literal::value, &literal::value);
+	}
+};
+// as combine_encoded in place, where max_variable is the largest one-indexed sat variable of
+// `clauses` (at least first_auxiliary_variable) and is updated to that of the result; clauses of
+// `part` found in `skipped`, sorted by clause_less, are left out
+extern auto append_encoded(
+	std::vector<clause>& clauses,
+	u64& max_variable,
+	sat const& part,
+	variable first_auxiliary_variable,
+	std::span<clause const> skipped = {}) -> void;
+extern auto mean_relation_density(csp const& csp) -> f64;
+// the value of each csp variable in encodings with one sat variable per (variable, value) pair
+extern auto decode_one_hot(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value>;
+extern auto n_nogoods(constraint const& _constraint, size_t domain_size) -> size_t;
+
+// the time taken by and the clauses produced by one encoding, in the global metrics registry
+struct encoding_metrics {
+	metric_histogram& seconds;
+	metric_histogram& clauses;
+};
+extern auto create_encoding_metrics(std::string const& encoding_name) -> encoding_metrics;
+
+// appends the clauses of every constraint to `clauses`, where constraint i has counts[i] of them;
+// the constraints are split into contiguous ranges of about equal clause counts, one per thread,
+// and fill(begin, end, out) writes the clauses of constraints [begin, end) from `out` on, so the
+// result is the same as generating them serially
+using clause_range_filler =
+	std::function<void(size_t begin, size_t end, std::vector<clause>::iterator out)>;
+extern auto fill_clauses_in_parallel(
+	std::vector<clause>& clauses,
+	std::span<size_t const> counts,
+	size_t n_threads,
+	clause_range_filler const& fill) -> void;
 } // namespace __internal
 
 using encoding = std::function<sat(csp const&)>;
+// recovers the value of each csp variable from a satisfying assignment of its encoding
+using decoder = std::function<std::vector<domain_value>(csp const&, assignment const&)>;
 using polymorphism_checker = std::function<satisfiability(relation)>;
+using multi_polymorphism_checker = std::function<std::vector<satisfiability>(relation)>;
 
 extern auto create_encoding_solver(operation const& op, encoding _encoding, solver _solver)
 	-> polymorphism_checker;
+// checks each operation against a relation, sharing the polymorphism constraints and their
+// encoding between operations of the same arity
+extern auto create_multi_encoding_solver(
+	std::vector<operation> const& operations, encoding _encoding, solver _solver)
+	-> multi_polymorphism_checker;
 
 } // namespace cspc
\ No newline at end of file
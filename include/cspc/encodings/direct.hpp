@@ -1,8 +1,38 @@
 #pragma once
 
 #include "../data_structures.hpp"
+#include "common.hpp"
 
 namespace cspc {
+namespace __internal {
+template <std::output_iterator<clause> outputiterator>
+auto conflict_clauses(
+	std::span<constraint const> nogoods, size_t domain_size, outputiterator result)
+	-> outputiterator {
+	std::ranges::for_each(nogoods, [&](constraint const& nogood) {
+		const auto arity = nogood.get_relation().arity();
+		result = std::ranges::transform(nogood.get_relation(), result, [&](auto const& entry) {
+					 auto _clause = clause{};
+					 _clause.reserve(arity);
+					 for (auto k = 0u; k < arity; ++k) {
+						 const auto xk_eq_nogoodjk = nogood.variables()[k] * domain_size + entry[k];
+						 _clause.push_back(literal(xk_eq_nogoodjk, NEGATED));
+					 }
+					 return _clause;
+				 }).out;
+	});
+	return result;
+}
+} // namespace __internal
+
 extern auto direct_encoding(csp const& csp) -> sat;
 extern auto multivalued_direct_encoding(csp const& csp) -> sat;
+extern auto direct_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto multivalued_direct_encoding_statistics(csp const& csp) -> encoding_statistics;
+// encodings identical to the serial ones, with the conflict clauses of the constraints generated
+// on `n_threads` threads
+extern auto create_parallel_direct_encoding(size_t n_threads) -> encoding;
+extern auto create_parallel_multivalued_direct_encoding(size_t n_threads) -> encoding;
+extern auto decode_direct_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value>;
 } // namespace cspc
@@ -1,8 +1,103 @@
 #pragma once
 
 #include "../data_structures.hpp"
+#include "common.hpp"
+#include <gautil/functional.hpp>
 
 namespace cspc {
+namespace __internal {
+// the constraints of a csp without those repeating an earlier constraint's scope and relation,
+// which would only get a duplicate block of entry variables and clauses
+extern auto distinct_label_cover_blocks(csp const& csp) -> cspc::csp;
+
+// the entry variables of the constraints are numbered consecutively from `first_entry_variable`
+template <std::output_iterator<clause> outputiterator>
+auto at_most_one_entry_clauses(
+	std::span<constraint const> constraints, size_t first_entry_variable, outputiterator result)
+	-> outputiterator {
+	auto variable_offset = first_entry_variable;
+	std::ranges::for_each(constraints, [&](auto const& constraint) {
+		const auto n_entries = constraint.get_relation().size();
+		for (auto j = 0u; j < n_entries; ++j) {
+			const auto entry_variable = variable_offset + j;
+			for (auto k = j + 1; k < n_entries; ++k) {
+				const auto other_entry_variable = variable_offset + k;
+				*result++ = {
+					literal(entry_variable, NEGATED),
+					literal(other_entry_variable, NEGATED),
+				};
+			}
+		}
+		variable_offset += n_entries;
+	});
+	return result;
+};
+
+template <std::output_iterator<clause> outputiterator>
+auto at_most_one_entry_clauses(csp const& csp, outputiterator result) -> outputiterator {
+	return at_most_one_entry_clauses(
+		csp.constraints(), csp.n_variables() * csp.domain_size(), result);
+}
+
+template <std::output_iterator<clause> outputiterator>
+auto at_least_one_entry_clauses(csp const& csp, outputiterator result) -> outputiterator {
+	auto variable_offset = csp.n_variables() * csp.domain_size();
+	return std::ranges::transform(
+			   csp.constraints(), result,
+			   [&](auto const& constraint) {
+				   const auto n_entries = constraint.get_relation().size();
+				   auto _clause = clause{};
+				   _clause.reserve(n_entries);
+				   gautil::repeat(n_entries, [&]() {
+					   _clause.push_back(literal(variable_offset++, REGULAR));
+				   });
+				   return _clause;
+			   })
+		.out;
+}
+
+template <std::output_iterator<clause> outputiterator>
+auto implication_clauses(
+	std::span<constraint const> constraints,
+	size_t domain_size,
+	size_t first_entry_variable,
+	outputiterator result) -> outputiterator {
+	auto variable_offset = first_entry_variable;
+	std::ranges::for_each(constraints, [&](auto const& constraint) {
+		// a variable representing an entry in a constraint relation implies an assignment to the
+		// variables which the relation concerns.
+		const auto arity = constraint.get_relation().arity();
+		std::ranges::for_each(constraint.get_relation(), [&](auto const& entry) {
+			const auto relation_entry_true = variable_offset++;
+			for (auto k = 0u; k < arity; ++k) {
+				const auto xk_eq_reljk = constraint.variables()[k] * domain_size + entry[k];
+				*result++ = clause{
+					literal(relation_entry_true, NEGATED),
+					literal(xk_eq_reljk, REGULAR),
+				};
+			}
+		});
+	});
+	return result;
+}
+
+template <std::output_iterator<clause> outputiterator>
+auto implication_clauses(csp const& csp, outputiterator result) -> outputiterator {
+	return implication_clauses(
+		csp.constraints(), csp.domain_size(), csp.n_variables() * csp.domain_size(), result);
+}
+} // namespace __internal
+
+// both share one block of entry variables between constraints with the same scope and relation,
+// and count the shared blocks in cspc_label_cover_shared_blocks_total
 extern auto label_cover_encoding(csp const& csp) -> sat;
 extern auto multivalued_label_cover_encoding(csp const& csp) -> sat;
+extern auto label_cover_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto multivalued_label_cover_encoding_statistics(csp const& csp) -> encoding_statistics;
+// encodings identical to the serial ones, with the clauses of each constraint generated on
+// `n_threads` threads
+extern auto create_parallel_label_cover_encoding(size_t n_threads) -> encoding;
+extern auto create_parallel_multivalued_label_cover_encoding(size_t n_threads) -> encoding;
+extern auto decode_label_cover_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value>;
 } // namespace cspc
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../data_structures.hpp"
+#include "common.hpp"
+
+namespace cspc {
+namespace __internal {
+constexpr auto MDD_ACCEPT = u32(-1);
+constexpr auto MDD_REJECT = u32(-2);
+
+// a reduced multi-valued decision diagram of a relation, where a node at layer k branches on the
+// k-th value of a tuple; isomorphic nodes are merged and a node whose children are all the same
+// terminal is replaced by it, so the diagram of a relation is also that of its complement with
+// the terminals swapped
+struct mdd {
+	size_t arity;
+	size_t domain_size;
+	// the children of node u are children[u * domain_size, (u + 1) * domain_size), each a node or
+	// a terminal; nodes only point at nodes created before them, so the root is the last node
+	std::vector<u32> children;
+	std::vector<u32> layers;
+
+	auto n_nodes() const -> size_t { return layers.size(); }
+	auto root() const -> u32 { return u32(n_nodes() - 1); }
+	auto child(u32 node, domain_value value) const -> u32 {
+		return children[node * domain_size + value];
+	}
+	// only one child, which is a node, so one clause stands for all of the node's values
+	auto has_single_child(u32 node) const -> bool;
+};
+
+extern auto compile_mdd(relation const& _relation, size_t domain_size) -> mdd;
+
+// the clauses of one constraint instantiating a diagram, with a sat variable for every node but
+// the root, which is always reached
+struct mdd_instance_statistics {
+	size_t n_variables;
+	size_t n_clauses;
+	size_t n_literals;
+};
+extern auto mdd_instance_statistics_of(mdd const& diagram) -> mdd_instance_statistics;
+
+// node u of the diagram (but the root) is sat variable first_node_variable + u; reaching a node
+// and assigning a value implies reaching the child, and a value leading to the reject terminal is
+// forbidden
+template <std::output_iterator<clause> outputiterator>
+auto mdd_clauses(
+	mdd const& diagram,
+	std::vector<variable> const& scope,
+	size_t first_node_variable,
+	outputiterator result) -> outputiterator {
+	const auto domain_size = diagram.domain_size;
+	const auto root = diagram.root();
+	const auto with_reached = [&](u32 node, clause _clause) {
+		if (node != root) {
+			_clause.insert(_clause.begin(), literal(first_node_variable + node, NEGATED));
+		}
+		return _clause;
+	};
+	for (auto node = u32(0); node < diagram.n_nodes(); ++node) {
+		if (diagram.has_single_child(node)) {
+			const auto child = diagram.child(node, 0);
+			*result++ = with_reached(node, {literal(first_node_variable + child, REGULAR)});
+			continue;
+		}
+		const auto x = scope[diagram.layers[node]];
+		for (auto a = domain_value(0); a < domain_size; ++a) {
+			const auto child = diagram.child(node, a);
+			const auto x_eq_a = literal(x * domain_size + a, NEGATED);
+			if (child == MDD_REJECT) {
+				*result++ = with_reached(node, {x_eq_a});
+			} else if (child != MDD_ACCEPT) {
+				*result++ =
+					with_reached(node, {x_eq_a, literal(first_node_variable + child, REGULAR)});
+			}
+		}
+	}
+	return result;
+}
+} // namespace __internal
+
+// the one-hot variables of the direct encodings, with each distinct relation compiled once into
+// a diagram that every constraint on it instantiates with its own node variables
+extern auto mdd_encoding(csp const& csp) -> sat;
+extern auto multivalued_mdd_encoding(csp const& csp) -> sat;
+extern auto mdd_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto multivalued_mdd_encoding_statistics(csp const& csp) -> encoding_statistics;
+extern auto decode_mdd_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value>;
+} // namespace cspc
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace cspc {
+// the instance in DIMACS CNF, with as many variables as the largest one used
+extern auto to_dimacs(sat const& sat) -> std::string;
+// the result of an "s SATISFIABLE" or "s UNSATISFIABLE" line, nothing for "s UNKNOWN" or no line
+extern auto parse_dimacs_result(std::string_view output) -> std::optional<satisfiability>;
+
+struct external_solver_options {
+	// the executable and its arguments, searched for in PATH; the instance is written to its
+	// standard input and the result read from its standard output
+	std::vector<std::string> command;
+	size_t max_processes;
+	// wall clock time before the process is killed, zero for no limit
+	std::chrono::milliseconds time_limit;
+	// address space of the process, zero for no limit
+	size_t memory_limit_bytes;
+};
+
+// runs an external solver in child processes, at most max_processes of them at once; callers
+// beyond that wait for a process to finish
+class external_solver_pool {
+  public:
+	explicit external_solver_pool(external_solver_options options)
+		: m_options{std::move(options)} {}
+
+	// nothing if the solver could not be started, crashed, ran out of time or memory, or did not
+	// report a result
+	auto solve(sat const& sat) -> std::optional<satisfiability>;
+	auto n_running() const -> size_t;
+
+  private:
+	external_solver_options m_options;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_slot_freed;
+	size_t m_n_running{0};
+};
+
+// solves with the pool and falls back to `fallback` for instances the external solver failed on,
+// so that a crashing solver only costs time
+extern auto create_external_solver(std::shared_ptr<external_solver_pool> pool, solver fallback)
+	-> solver;
+} // namespace cspc
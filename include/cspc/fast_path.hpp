@@ -0,0 +1,52 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <atomic>
+#include <memory>
+
+namespace cspc {
+// decides whether a relation has a polymorphism satisfying the operation's identities without
+// constructing a meta-CSP, or returns nothing if the rule does not apply
+struct fast_path_rule {
+	std::string name;
+	std::function<std::optional<satisfiability>(operation const&, relation const&)> decide;
+};
+
+struct fast_path_decision {
+	size_t rule; // index into the rule set
+	satisfiability result;
+};
+
+// per rule hit counts, safe to update from several threads
+class fast_path_statistics {
+  public:
+	fast_path_statistics(size_t n_rules) : m_hits(n_rules) {}
+	auto record_hit(size_t rule) -> void { m_hits[rule].fetch_add(1, std::memory_order_relaxed); }
+	auto record_miss() -> void { m_misses.fetch_add(1, std::memory_order_relaxed); }
+	auto hits(size_t rule) const -> size_t { return m_hits[rule].load(std::memory_order_relaxed); }
+	auto misses() const -> size_t { return m_misses.load(std::memory_order_relaxed); }
+	auto n_rules() const -> size_t { return m_hits.size(); }
+
+  private:
+	std::vector<std::atomic<size_t>> m_hits;
+	std::atomic<size_t> m_misses{0};
+};
+
+extern auto empty_relation_rule() -> fast_path_rule;
+extern auto full_relation_rule() -> fast_path_rule;
+extern auto constant_tuple_rule() -> fast_path_rule;
+extern auto semilattice_rule() -> fast_path_rule;
+extern auto default_fast_path_rules() -> std::vector<fast_path_rule>;
+
+extern auto classify_fast_path(
+	operation const& _operation, relation const& _relation, std::vector<fast_path_rule> const& rules)
+	-> std::optional<fast_path_decision>;
+
+// runs the rules in order and falls back on `checker` when none of them apply
+extern auto create_fast_path_checker(
+	operation const& _operation,
+	std::vector<fast_path_rule> rules,
+	polymorphism_checker checker,
+	std::shared_ptr<fast_path_statistics> statistics = nullptr) -> polymorphism_checker;
+} // namespace cspc
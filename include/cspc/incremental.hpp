@@ -0,0 +1,67 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cspc {
+// the clauses that turn the encoding of one relation into that of the next
+struct clause_delta {
+	std::vector<clause> added;
+	std::vector<clause> removed;
+};
+
+// the direct encoding of the meta-CSP of an operation and a relation that is updated one tuple at
+// a time; each polymorphism constraint contributes one conflict clause per nogood, so inserting
+// or erasing a tuple only touches the clauses of that nogood and of the scopes built from it
+class incremental_meta_csp {
+  public:
+	// `_encoding` encodes the identity constraints and must be one of the direct encodings, whose
+	// variable layout the conflict clauses share
+	incremental_meta_csp(
+		operation const& _operation, size_t arity, size_t domain_size, encoding _encoding);
+
+	auto insert(relation_entry const& tuple) -> clause_delta;
+	auto erase(relation_entry const& tuple) -> clause_delta;
+	// inserts and erases whatever tuples differ between the current relation and `_relation`
+	auto assign(relation const& _relation) -> clause_delta;
+
+	auto arity() const -> size_t { return m_arity; }
+	auto domain_size() const -> size_t { return m_domain_size; }
+	auto current_relation() const -> relation;
+	auto encoded() const -> sat;
+
+  private:
+	// calls fn with the key and scope of every choice of operation arity many rows of the
+	// relation, or only of those choices that include `row`
+	template <typename Function>
+	auto for_each_scope(std::optional<u32> row, Function fn) const -> void;
+	auto conflict_clause(std::vector<variable> const& scope, u32 nogood) const -> clause;
+	auto add_clause(u64 key, clause _clause, clause_delta& delta) -> void;
+	auto remove_clause(u64 key, clause_delta& delta) -> void;
+
+	size_t m_operation_arity;
+	size_t m_arity;
+	size_t m_domain_size;
+	size_t m_n_tuples;
+	sat m_identity_clauses;
+	// m_tuples[t] is the t:th tuple in the order of index_to_function_input
+	std::vector<relation_entry> m_tuples;
+	std::vector<bool> m_contains;
+	std::vector<u32> m_rows;
+	// conflict clauses keyed by scope key * m_n_tuples + nogood
+	std::vector<clause> m_clauses;
+	std::vector<u64> m_clause_keys;
+	std::unordered_map<u64, size_t> m_clause_positions;
+};
+
+// classifies relations by moving a single incremental meta-CSP from one relation to the next,
+// which is cheapest when neighboring relations differ in few tuples as in
+// gray_code_nary_relations; the meta-CSP is built over `domain_size` rather than the domain of
+// each relation, and relations with values outside of it are built from scratch
+extern auto create_incremental_encoding_solver(
+	operation const& _operation, size_t domain_size, encoding _encoding, solver _solver)
+	-> polymorphism_checker;
+} // namespace cspc
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "data_structures.hpp"
+
+namespace cspc {
+// a relation stored once for every relation equal to it that has been interned, sorted so that
+// membership is logarithmic; interned relations compare and hash by address, and live until the
+// program exits
+class interned_relation {
+  public:
+	auto get() const -> relation const& { return *m_relation; }
+	auto operator*() const -> relation const& { return *m_relation; }
+	auto operator->() const -> relation const* { return m_relation; }
+	auto operator==(interned_relation const& other) const -> bool {
+		return m_relation == other.m_relation;
+	}
+
+  private:
+	explicit interned_relation(relation const* _relation) : m_relation{_relation} {}
+	friend auto intern(relation const& _relation) -> interned_relation;
+
+	relation const* m_relation;
+};
+
+extern auto intern(relation const& _relation) -> interned_relation;
+// the number of distinct relations interned so far
+extern auto n_interned_relations() -> size_t;
+} // namespace cspc
+
+template <> struct std::hash<cspc::interned_relation> {
+	auto operator()(cspc::interned_relation const& _relation) const noexcept -> size_t {
+		return std::hash<cspc::relation const*>{}(&_relation.get());
+	}
+};
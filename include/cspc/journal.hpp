@@ -0,0 +1,58 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cspc {
+struct journal_entry {
+	size_t index;
+	satisfiability result;
+	u64 solve_time_ns;
+};
+
+struct journal_options {
+	size_t records_per_sync = 1024;
+	std::chrono::milliseconds sync_interval = std::chrono::milliseconds(1000);
+};
+
+// an append-only record of finished relations that survives crashes; records are written and
+// synced to disk in batches, so at most one batch is lost
+class journal {
+  public:
+	journal(journal const&) = delete;
+	auto operator=(journal const&) -> journal& = delete;
+	~journal();
+
+	// opens the journal at path, creating it if needed; `parameters` identifies the sweep and
+	// must match those of an existing journal
+	static auto open(
+		std::filesystem::path const& path,
+		std::string const& parameters,
+		journal_options options = {}) -> std::unique_ptr<journal>;
+
+	auto find(size_t index) const -> std::optional<journal_entry>;
+	auto size() const -> size_t;
+	auto record(journal_entry const& entry) -> void;
+	auto flush() -> void;
+
+  private:
+	journal(int fd, journal_options options, std::vector<journal_entry> const& entries);
+	auto write_buffer() -> void;
+
+	int m_fd;
+	journal_options m_options;
+	mutable std::mutex m_mutex;
+	std::unordered_map<size_t, journal_entry> m_entries;
+	std::string m_buffer;
+	size_t m_n_buffered{0};
+	std::chrono::steady_clock::time_point m_last_sync;
+};
+
+// every complete record of a journal, ignoring a torn final line
+extern auto load_journal(std::filesystem::path const& path, std::string const& parameters)
+	-> std::optional<std::vector<journal_entry>>;
+} // namespace cspc
@@ -2,6 +2,7 @@
 
 #include "data_structures.hpp"
 #include <cspc/formatters.hpp>
+#include <map>
 
 extern "C" {
 #include <kissat.h>
@@ -9,4 +10,28 @@ extern "C" {
 
 namespace cspc {
 extern auto kissat_is_satisfiable(sat const& sat) -> satisfiability;
-}
+extern auto kissat_find_model(sat const& sat) -> std::optional<assignment>;
+extern auto kissat_is_satisfiable_flat(flat_clauses clauses) -> satisfiability;
+
+// kissat settings applied before any clause is added; option names kissat does not know are
+// ignored by kissat itself
+struct kissat_options {
+	// one of kissat's configurations, "default", "plain", "sat" or "unsat"; empty keeps kissat's
+	// default
+	std::string configuration;
+	// set after the configuration, so they override its values
+	std::map<std::string, int> options;
+};
+
+struct kissat_preset {
+	std::string name;
+	kissat_options options;
+};
+
+extern auto kissat_presets() -> std::vector<kissat_preset> const&;
+extern auto find_kissat_preset(std::string const& name) -> std::optional<kissat_options>;
+
+extern auto create_kissat_solver(kissat_options const& options) -> solver;
+extern auto create_kissat_model_solver(kissat_options const& options) -> model_solver;
+extern auto create_kissat_flat_solver(kissat_options const& options) -> flat_solver;
+} // namespace cspc
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+namespace cspc {
+using language_checker = std::function<satisfiability(constraint_language)>;
+
+// the encoded meta-CSP of an operation and a constraint language that grows one relation at a
+// time; every relation constrains the same function table, so inserting a relation only encodes
+// its own polymorphism constraints and appends their clauses
+class language_meta_csp {
+  public:
+	language_meta_csp(operation const& _operation, size_t domain_size, encoding _encoding);
+
+	// relations already in the language are skipped
+	auto insert(relation const& _relation) -> void;
+	auto contains(relation const& _relation) const -> bool {
+		return m_relations.contains(_relation);
+	}
+
+	auto domain_size() const -> size_t { return m_domain_size; }
+	auto language() const -> constraint_language const& { return m_language; }
+	auto encoded() const -> sat { return sat(m_clauses); }
+
+  private:
+	size_t m_operation_arity;
+	size_t m_domain_size;
+	encoding m_encoding;
+	// the function table followed by one variable per domain value, as in
+	// construct_preserves_operation_csp; sat variables past them belong to a single part
+	size_t m_n_variables;
+	// the clauses the encoding emits on those variables alone, sorted by clause_less; the identity
+	// block brings them in once and they are left out of every relation's block
+	std::vector<clause> m_variable_clauses;
+	constraint_language m_language;
+	std::unordered_set<relation> m_relations;
+	std::vector<clause> m_clauses;
+	u64 m_max_variable;
+};
+
+// checks that the operation preserves every relation of a language; while each language only adds
+// relations to the one checked before it on the same domain, the previous meta-CSP is extended
+// rather than built from scratch
+extern auto create_language_encoding_solver(
+	operation const& _operation, encoding _encoding, solver _solver) -> language_checker;
+// as above over at least `domain_size` values, so that sublanguages of a language using fewer
+// values are still checked on its domain
+extern auto create_language_encoding_solver(
+	operation const& _operation, size_t domain_size, encoding _encoding, solver _solver)
+	-> language_checker;
+} // namespace cspc
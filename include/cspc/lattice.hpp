@@ -0,0 +1,37 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "language.hpp"
+
+namespace cspc {
+// languages are subsets of a pool of relations, where bit i of a subset selects relation i
+constexpr auto MAX_LATTICE_POOL_SIZE = size_t(24);
+
+extern auto sublanguage(constraint_language const& pool, u64 subset) -> constraint_language;
+
+// the subsets of n elements partitioned into chains, each subset in a chain adding one element to
+// the one before it; the chains are symmetric around the middle rank, so there are as few of them
+// as there are subsets of size n / 2
+extern auto symmetric_chains(size_t n) -> std::vector<std::vector<u64>>;
+
+struct lattice_result {
+	satisfiability result;
+	// decided from the result of a superlanguage or a sublanguage rather than solved
+	bool inferred;
+};
+
+struct lattice_sweep {
+	// indexed by subset
+	std::vector<lattice_result> results;
+	size_t n_solved;
+	size_t n_inferred;
+};
+
+// classifies every sublanguage of the pool; an operation preserving a language preserves its
+// sublanguages, so a satisfiable result decides every subset and an unsatisfiable one every
+// superset, and only the undecided middle of each chain is bisected with the checker; the
+// checker should check every sublanguage on the domain of the whole pool, for which the
+// inference holds
+extern auto sweep_language_lattice(constraint_language const& pool, language_checker const& checker)
+	-> lattice_sweep;
+} // namespace cspc
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <gautil/math.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace cspc {
+// recording into any metric is a relaxed atomic update, so it is safe from any thread and cheap
+// enough for per relation instrumentation; only looking a metric up in the registry takes a lock
+class metric_counter {
+  public:
+	auto add(u64 n = 1) -> void { m_value.fetch_add(n, std::memory_order_relaxed); }
+	auto value() const -> u64 { return m_value.load(std::memory_order_relaxed); }
+
+  private:
+	std::atomic<u64> m_value{0};
+};
+
+class metric_gauge {
+  public:
+	auto set(i64 value) -> void { m_value.store(value, std::memory_order_relaxed); }
+	auto add(i64 n) -> void { m_value.fetch_add(n, std::memory_order_relaxed); }
+	auto value() const -> i64 { return m_value.load(std::memory_order_relaxed); }
+
+  private:
+	std::atomic<i64> m_value{0};
+};
+
+// a log-linear histogram of integer values; `unit` converts them to the exported unit, e.g. 1e-9
+// for durations recorded in nanoseconds and exported in seconds
+class metric_histogram {
+  public:
+	explicit metric_histogram(f64 unit) : m_unit{unit} {}
+
+	auto record(u64 value) -> void;
+	auto record(std::chrono::nanoseconds duration) -> void;
+	auto bucket(size_t i) const -> u64 { return m_buckets[i].load(std::memory_order_relaxed); }
+	auto sum() const -> u64 { return m_sum.load(std::memory_order_relaxed); }
+	auto unit() const -> f64 { return m_unit; }
+
+  private:
+	f64 m_unit;
+	std::array<std::atomic<u64>, gautil::N_LOG_LINEAR_BUCKETS> m_buckets{};
+	std::atomic<u64> m_sum{0};
+};
+
+// records the time from construction to destruction in nanoseconds
+class scoped_timer {
+  public:
+	explicit scoped_timer(metric_histogram& histogram)
+		: m_histogram{histogram}, m_start{std::chrono::steady_clock::now()} {}
+	scoped_timer(scoped_timer const&) = delete;
+	auto operator=(scoped_timer const&) -> scoped_timer& = delete;
+	~scoped_timer() { m_histogram.record(std::chrono::steady_clock::now() - m_start); }
+
+  private:
+	metric_histogram& m_histogram;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+constexpr auto METRIC_SECONDS = f64{1e-9};
+
+using metric_labels = std::vector<std::pair<std::string, std::string>>;
+
+namespace __internal {
+template <typename Metric> struct metric_family {
+	std::string help;
+	// by formatted labels
+	std::map<std::string, std::unique_ptr<Metric>> series;
+};
+} // namespace __internal
+
+// metrics by name and labels; a metric is created on first lookup and lives as long as the
+// registry, so instrumentation looks it up once and keeps the reference
+class metrics_registry {
+  public:
+	auto counter(std::string const& name, std::string const& help, metric_labels const& labels = {})
+		-> metric_counter&;
+	auto gauge(std::string const& name, std::string const& help, metric_labels const& labels = {})
+		-> metric_gauge&;
+	auto histogram(
+		std::string const& name,
+		std::string const& help,
+		f64 unit,
+		metric_labels const& labels = {}) -> metric_histogram&;
+
+	// every metric in the Prometheus text exposition format
+	auto prometheus_text() const -> std::string;
+
+  private:
+	mutable std::mutex m_mutex;
+	std::map<std::string, __internal::metric_family<metric_counter>> m_counters;
+	std::map<std::string, __internal::metric_family<metric_gauge>> m_gauges;
+	std::map<std::string, __internal::metric_family<metric_histogram>> m_histograms;
+};
+
+// the registry the library's own instrumentation records into
+extern auto global_metrics() -> metrics_registry&;
+
+// replaces the file with the registry's Prometheus text, so readers never see a partial dump
+extern auto write_metrics(metrics_registry const& registry, std::filesystem::path const& path)
+	-> bool;
+
+// writes the registry to a file every interval from a background thread, and once more when
+// destroyed so that the file ends with the final values
+class metrics_file_exporter {
+  public:
+	metrics_file_exporter(
+		metrics_registry const& registry,
+		std::filesystem::path path,
+		std::chrono::milliseconds interval);
+	metrics_file_exporter(metrics_file_exporter const&) = delete;
+	auto operator=(metrics_file_exporter const&) -> metrics_file_exporter& = delete;
+	~metrics_file_exporter();
+
+  private:
+	auto export_loop(std::stop_token stop) -> void;
+
+	metrics_registry const& m_registry;
+	const std::filesystem::path m_path;
+	const std::chrono::milliseconds m_interval;
+	std::mutex m_mutex;
+	std::condition_variable_any m_wake;
+	std::jthread m_export_thread;
+};
+
+// answers every connection to a Unix domain socket with the registry's current Prometheus text
+// and closes it, e.g. for `socat - UNIX-CONNECT:<path>` from a scraper
+class metrics_socket_exporter {
+  public:
+	explicit metrics_socket_exporter(metrics_registry const& registry) : m_registry{registry} {}
+	metrics_socket_exporter(metrics_socket_exporter const&) = delete;
+	auto operator=(metrics_socket_exporter const&) -> metrics_socket_exporter& = delete;
+	~metrics_socket_exporter();
+
+	auto listen(std::filesystem::path const& path) -> bool;
+	auto stop() -> void;
+
+  private:
+	auto accept_loop(std::stop_token stop) -> void;
+
+	metrics_registry const& m_registry;
+	std::filesystem::path m_path;
+	int m_listen_fd{-1};
+	std::jthread m_acceptor;
+};
+} // namespace cspc
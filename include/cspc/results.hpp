@@ -0,0 +1,91 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include "fast_path.hpp"
+#include <array>
+#include <filesystem>
+#include <memory>
+
+namespace cspc {
+// A result store is a binary file of one fixed size record per relation index, stored column by
+// column so that a query only touches the columns it reads:
+//   0   "CSPCRES1", u32 version, u32 zero, u64 number of relations, zero padding up to 64
+//   64  the class of every relation in 2 bits, in u64 words
+//   ... u64 solve time in nanoseconds per relation
+//   ... u64 number of clauses per relation
+//   ... u8 per relation, one more than the fast path rule that decided it or 0 if none did
+// All integers are little endian. Relations that were never recorded are of UNKNOWN class.
+
+enum relation_class : u8 {
+	UNKNOWN_CLASS = 0,
+	POLYNOMIAL,
+	NP_HARD,
+};
+
+// the class of a relation from whether it has a siggers polymorphism; the result for any other
+// operation says nothing about the class
+extern auto to_relation_class(satisfiability result) -> relation_class;
+
+struct result_record {
+	relation_class classification;
+	u64 solve_time_ns;
+	u64 n_clauses; // 0 if no sat instance was built
+	std::optional<size_t> fast_path_rule;
+};
+
+// a memory mapped result store; records of different relations may be set from several threads
+class result_store {
+  public:
+	result_store(result_store const&) = delete;
+	auto operator=(result_store const&) -> result_store& = delete;
+	~result_store();
+
+	// creates a store of n_relations unknown records, replacing any existing file
+	static auto create(std::filesystem::path const& path, size_t n_relations)
+		-> std::unique_ptr<result_store>;
+	static auto open(std::filesystem::path const& path, bool writable = false)
+		-> std::unique_ptr<result_store>;
+
+	auto size() const -> size_t { return m_n_relations; }
+	auto classification(size_t index) const -> relation_class;
+	auto get(size_t index) const -> result_record;
+	auto set(size_t index, result_record const& record) -> void;
+
+  private:
+	result_store(void* mapping, size_t mapping_size, size_t n_relations);
+
+	void* m_mapping;
+	size_t m_mapping_size;
+	size_t m_n_relations;
+	u64* m_classes;
+	u64* m_solve_times;
+	u64* m_n_clauses;
+	u8* m_fast_path_rules;
+};
+
+struct result_summary {
+	std::array<size_t, 3> class_counts; // indexed by relation_class
+	std::vector<size_t> fast_path_counts; // indexed by rule
+	u64 total_solve_time_ns;
+	u64 total_clauses;
+	// approximate solve time percentiles of the recorded relations, from a log-linear histogram
+	u64 solve_time_p50_ns;
+	u64 solve_time_p90_ns;
+	u64 solve_time_p99_ns;
+	u64 solve_time_max_ns;
+};
+
+// aggregates a range of records in one pass over the mapped columns
+extern auto summarize_results(result_store const& store, size_t first, size_t last)
+	-> result_summary;
+
+// classifies with the fast path rules, then by encoding and solving the siggers meta-CSP, and
+// records the class, time, clause count and deciding rule of relation `index` in the store; the
+// siggers operation is fixed, as only it decides between P and NP-hard
+extern auto create_recording_checker(
+	std::vector<fast_path_rule> rules,
+	encoding _encoding,
+	solver _solver,
+	std::shared_ptr<result_store> store) -> std::function<satisfiability(size_t, relation const&)>;
+} // namespace cspc
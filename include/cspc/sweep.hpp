@@ -0,0 +1,43 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <filesystem>
+
+namespace cspc {
+// the half-open range [begin, end) of relation indices handled by one shard
+struct shard {
+	size_t index;
+	size_t begin;
+	size_t end;
+};
+
+struct supervisor_options {
+	size_t n_workers;
+	size_t max_restarts; // per shard
+};
+
+extern auto shard_range(size_t n_items, size_t shard_index, size_t n_shards) -> shard;
+extern auto shard_result_path(std::filesystem::path const& directory, size_t shard_index)
+	-> std::filesystem::path;
+
+// classifies the relations of a shard into a journal, resuming from an earlier partial run; the
+// result file only appears once the shard is complete
+extern auto run_shard(
+	std::vector<relation> const& relations,
+	shard const& _shard,
+	polymorphism_checker const& checker,
+	std::filesystem::path const& directory) -> bool;
+
+// runs every shard without a result file in a worker process, restarting workers that fail
+extern auto supervise_shards(
+	size_t n_shards,
+	std::filesystem::path const& directory,
+	std::function<std::vector<std::string>(size_t shard_index)> const& worker_command,
+	supervisor_options const& options) -> bool;
+
+// the results of all shards in relation index order, or nothing if any are missing
+extern auto merge_shard_results(
+	std::filesystem::path const& directory, size_t n_shards, size_t n_items)
+	-> std::optional<std::vector<satisfiability>>;
+} // namespace cspc
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "data_structures.hpp"
+#include "encodings/common.hpp"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace cspc {
+// an operation given by its values on every input, in the order of index_to_function_input
+struct function_table {
+	size_t arity;
+	size_t domain_size;
+	std::vector<domain_value> values;
+};
+
+extern auto preserves(function_table const& table, relation const& _relation) -> bool;
+
+// the most recently found polymorphisms, most recently used first; each is kept with the operation
+// whose identities it satisfies, so that checkers of different operations can share a cache
+class witness_cache {
+  public:
+	witness_cache(size_t capacity) : m_capacity{capacity} {}
+
+	// a cached table of the operation preserving the relation, if any
+	auto find(operation const& _operation, relation const& _relation)
+		-> std::optional<function_table>;
+	auto insert(operation const& _operation, function_table table) -> void;
+	auto hits() const -> size_t { return m_hits.load(std::memory_order_relaxed); }
+	auto misses() const -> size_t { return m_misses.load(std::memory_order_relaxed); }
+
+  private:
+	std::mutex m_mutex;
+	std::list<std::pair<operation, function_table>> m_tables;
+	size_t m_capacity;
+	std::atomic<size_t> m_hits{0};
+	std::atomic<size_t> m_misses{0};
+};
+
+// answers satisfiable without solving when a previously found polymorphism preserves the
+// relation, and otherwise adds the polymorphism found by the solver to the cache
+extern auto create_witness_caching_solver(
+	operation const& _operation,
+	encoding _encoding,
+	decoder _decoder,
+	model_solver _solver,
+	std::shared_ptr<witness_cache> cache) -> polymorphism_checker;
+} // namespace cspc
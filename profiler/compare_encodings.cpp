@@ -1,16 +1,29 @@
 #include "cspc/data_structures.hpp"
 #include "cspc/encodings/direct.hpp"
 #include <algorithm>
+#include <array>
 #include <cspc/algorithms.hpp>
+#include <cspc/encodings/auto.hpp>
 #include <cspc/encodings/binary.hpp>
 #include <cspc/encodings/direct.hpp>
 #include <cspc/encodings/label_cover.hpp>
+#include <cspc/encodings/mdd.hpp>
 #include <cspc/kissat.hpp>
 #include <execution>
 #include <gautil/functional.hpp>
 #include <gautil/math.hpp>
 
+// usage:
+//   cspc_profiler_compare_encodings
+//     profiles every encoding on bundles of relations
+//   cspc_profiler_compare_encodings --fit
+//     times each candidate of auto_encoding on every relation of the fit bundles and fits its cost
+//     model by least squares of the time against the candidate's statistics, printing the weights
+//     in the form of default_encoding_candidates
+
 constexpr auto N_SAMPLES = 30;
+// each fit instance is encoded and solved this many times, and the median time is fitted
+constexpr auto N_FIT_REPETITIONS = 5;
 
 auto duration_to_precise_ms(auto duration) -> f64 {
 	return (f64)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() /
@@ -162,7 +175,157 @@ auto show_profiles_raw(
 	}
 }
 
-auto main() -> int {
+struct fit_sample {
+	std::array<f64, 4> features; // as in encoding_cost_model
+	f64 time_ms;
+};
+
+auto fit_features(cspc::encoding_statistics const& statistics) -> std::array<f64, 4> {
+	return {
+		f64(statistics.n_variables), f64(statistics.n_clauses), f64(statistics.n_literals),
+		statistics.relation_density};
+}
+
+// median time to encode and solve the csp
+auto time_encode_and_solve(cspc::encoding const& encoding, cspc::csp const& csp) -> f64 {
+	auto times = std::vector<f64>{};
+	for (auto i = 0; i < N_FIT_REPETITIONS; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		cspc::kissat_is_satisfiable(encoding(csp));
+		times.push_back(duration_to_precise_ms(std::chrono::steady_clock::now() - start));
+	}
+	std::ranges::nth_element(times, times.begin() + times.size() / 2);
+	return times[times.size() / 2];
+}
+
+// solves the normal equations of the active features by Gaussian elimination, with the features
+// scaled to unit root mean square so that clause counts and densities are comparable
+auto least_squares(std::vector<fit_sample> const& samples, std::array<bool, 4> const& active)
+	-> std::array<f64, 4> {
+	auto columns = std::vector<size_t>{};
+	for (auto j = size_t(0); j < active.size(); ++j) {
+		if (active[j]) {
+			columns.push_back(j);
+		}
+	}
+	const auto n = columns.size();
+	auto scale = std::vector<f64>(n, 0.0);
+	for (auto const& sample : samples) {
+		for (auto a = size_t(0); a < n; ++a) {
+			scale[a] += sample.features[columns[a]] * sample.features[columns[a]];
+		}
+	}
+	for (auto& s : scale) {
+		s = s > 0 ? std::sqrt(s / f64(samples.size())) : 1.0;
+	}
+	// the augmented matrix [X^T X | X^T y] of the scaled features
+	auto m = std::vector<std::vector<f64>>(n, std::vector<f64>(n + 1, 0.0));
+	for (auto const& sample : samples) {
+		for (auto a = size_t(0); a < n; ++a) {
+			const auto xa = sample.features[columns[a]] / scale[a];
+			for (auto b = size_t(0); b < n; ++b) {
+				m[a][b] += xa * sample.features[columns[b]] / scale[b];
+			}
+			m[a][n] += xa * sample.time_ms;
+		}
+	}
+	for (auto a = size_t(0); a < n; ++a) {
+		const auto pivot = std::ranges::max_element(
+			m.begin() + a, m.end(), {}, [&](auto const& row) { return std::abs(row[a]); });
+		std::swap(m[a], *pivot);
+		if (std::abs(m[a][a]) < 1e-12) {
+			continue;
+		}
+		for (auto b = size_t(0); b < n; ++b) {
+			if (b == a) {
+				continue;
+			}
+			const auto factor = m[b][a] / m[a][a];
+			for (auto c = a; c <= n; ++c) {
+				m[b][c] -= factor * m[a][c];
+			}
+		}
+	}
+	auto weights = std::array<f64, 4>{};
+	for (auto a = size_t(0); a < n; ++a) {
+		weights[columns[a]] = std::abs(m[a][a]) < 1e-12 ? 0.0 : m[a][n] / m[a][a] / scale[a];
+	}
+	return weights;
+}
+
+// least squares with the weights kept non-negative, since a cost that falls as an instance grows
+// would only fit noise: the most negative weight is dropped and the rest refitted until none is
+auto fit_cost_model(std::vector<fit_sample> const& samples) -> cspc::encoding_cost_model {
+	auto active = std::array<bool, 4>{true, true, true, true};
+	auto weights = least_squares(samples, active);
+	while (true) {
+		const auto most_negative = std::ranges::min_element(weights);
+		if (*most_negative >= 0) {
+			break;
+		}
+		active[most_negative - weights.begin()] = false;
+		weights = least_squares(samples, active);
+	}
+	return cspc::encoding_cost_model{
+		.per_variable = weights[0],
+		.per_clause = weights[1],
+		.per_literal = weights[2],
+		.per_relation_density = weights[3],
+	};
+}
+
+// the fraction of the variance in time the model explains
+auto r_squared(std::vector<fit_sample> const& samples, cspc::encoding_cost_model const& model)
+	-> f64 {
+	const auto mean = gautil::fold(samples, 0.0, std::plus{}, &fit_sample::time_ms) /
+					  f64(samples.size());
+	auto residual = 0.0;
+	auto total = 0.0;
+	for (auto const& sample : samples) {
+		const auto [v, c, l, d] = sample.features;
+		const auto predicted = model.per_variable * v + model.per_clause * c +
+							   model.per_literal * l + model.per_relation_density * d;
+		residual += (sample.time_ms - predicted) * (sample.time_ms - predicted);
+		total += (sample.time_ms - mean) * (sample.time_ms - mean);
+	}
+	return total > 0 ? 1.0 - residual / total : 1.0;
+}
+
+auto fit(std::vector<Labeled<std::vector<cspc::relation>>> const& labeled_relations) -> int {
+	const auto siggers = cspc::siggers_operation();
+	auto csps = std::vector<cspc::csp>{};
+	for (auto const& [label, relations] : labeled_relations) {
+		std::ranges::transform(relations, std::back_inserter(csps), [&](auto const& relation) {
+			return cspc::construct_preserves_operation_csp(siggers, relation);
+		});
+	}
+	// the weights only hold for the solver they were fitted with
+	spdlog::info(
+		"Fitting the cost models on {} meta-CSPs with {}", csps.size(), kissat_signature());
+	for (auto const& candidate : cspc::default_encoding_candidates()) {
+		auto samples = std::vector<fit_sample>{};
+		for (auto const& csp : csps) {
+			samples.push_back(fit_sample{
+				.features = fit_features(candidate.statistics(csp)),
+				.time_ms = time_encode_and_solve(candidate.encode, csp),
+			});
+		}
+		const auto model = fit_cost_model(samples);
+		spdlog::info(
+			"{:24} {{{:.3g}, {:.3g}, {:.3g}, {:.3g}}} R^2 = {:.3f}", candidate.name,
+			model.per_variable, model.per_clause, model.per_literal, model.per_relation_density,
+			r_squared(samples, model));
+	}
+	return EXIT_SUCCESS;
+}
+
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv + 1, argv + argc);
+	if (args.size() > 1 || (args.size() == 1 && args[0] != "--fit")) {
+		spdlog::error("Usage: cspc_profiler_compare_encodings [--fit]");
+		return EXIT_FAILURE;
+	}
+
 	const auto labeled_encodings = std::vector<Labeled<std::function<cspc::sat(cspc::csp const&)>>>{
 		{"Direct encoding", cspc::direct_encoding},
 		{"Multivalued direct encoding", cspc::multivalued_direct_encoding},
@@ -170,6 +333,9 @@ auto main() -> int {
 		{"Log encoding", cspc::log_encoding},
 		{"Label cover encoding", cspc::label_cover_encoding},
 		{"Multivalued label cover encoding", cspc::multivalued_label_cover_encoding},
+		{"MDD encoding", cspc::mdd_encoding},
+		{"Multivalued MDD encoding", cspc::multivalued_mdd_encoding},
+		{"Auto encoding", cspc::auto_encoding},
 	};
 	const auto labeled_relations = std::vector<Labeled<std::vector<cspc::relation>>>{
 		{"All binary on domain [0, 2)", cspc::all_nary_relations(2, 2)},
@@ -181,6 +347,18 @@ auto main() -> int {
 		{"{!=} on domain [0, 5)", {cspc::neq_relation(2, 5)}},
 		{"{!=, ==} on domain [0, 4)", {cspc::neq_relation(2, 4), cspc::eq_relation(2, 4)}},
 	};
+	if (!args.empty()) {
+		// the profiled bundles but {!=} on five values, whose meta-CSP alone would outweigh every
+		// other instance in the fit
+		return fit({
+			{"All binary on domain [0, 2)", cspc::all_nary_relations(2, 2)},
+			{"All binary on domain [0, 3)", cspc::all_nary_relations(2, 3)},
+			{"All ternary on domain [0, 2)", cspc::all_nary_relations(3, 2)},
+			{"{!=} on domain [0, 4)", {cspc::neq_relation(2, 4)}},
+			{"{!=, ==} on domain [0, 4)", {cspc::neq_relation(2, 4), cspc::eq_relation(2, 4)}},
+		});
+	}
+
 	auto profiles = std::vector<Labeled<std::vector<Labeled<Profile>>>>{};
 	std::ranges::transform(
 		labeled_encodings, std::back_inserter(profiles), [&](auto const& labeled_encoding) {
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/binary.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/encodings/label_cover.hpp>
+#include <fmt/format.h>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <unordered_map>
+
+// usage:
+//   cspc_profiler_microbenchmarks [--filter <substring>] [--samples <n>] [--json <path>]
+//     times internal hot functions over grids of (arity, domain size, relation size); every
+//     benchmark is warmed up, calibrated to run long enough per sample for the clock to be
+//     accurate, and sampled repeatedly so that changes can be told apart from noise
+
+constexpr auto DEFAULT_N_SAMPLES = size_t{20};
+constexpr auto WARMUP_TIME = std::chrono::milliseconds(50);
+constexpr auto MIN_SAMPLE_TIME = std::chrono::milliseconds(5);
+constexpr auto RELATION_SEED = 0x5eed;
+
+// keeps the compiler from optimizing away a result that is never read
+template <typename T> auto do_not_optimize(T const& value) -> void {
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct grid_point {
+	size_t arity;
+	size_t domain_size;
+	size_t relation_size;
+};
+
+struct benchmark {
+	std::string name;
+	std::vector<grid_point> grid;
+	// prepares the inputs of a grid point outside of the timed region and returns the timed call
+	std::function<std::function<void()>(grid_point const&)> setup;
+};
+
+struct measurement {
+	std::string name;
+	grid_point point;
+	size_t iterations_per_sample;
+	std::vector<f64> ns_per_iteration; // one per sample
+};
+
+struct summary {
+	f64 min;
+	f64 median;
+	f64 mean;
+	f64 stddev;
+};
+
+auto summarize(std::vector<f64> samples) -> summary {
+	std::ranges::sort(samples);
+	const auto n = f64(samples.size());
+	const auto mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+	const auto variance =
+		std::accumulate(
+			samples.begin(), samples.end(), 0.0,
+			[&](f64 sum, f64 sample) { return sum + (sample - mean) * (sample - mean); }) /
+		std::max(n - 1, 1.0);
+	const auto middle = samples.size() / 2;
+	return summary{
+		.min = samples.front(),
+		.median = samples.size() % 2 == 1 ? samples[middle]
+										  : (samples[middle - 1] + samples[middle]) / 2,
+		.mean = mean,
+		.stddev = std::sqrt(variance),
+	};
+}
+
+auto run_benchmark(std::string const& name, grid_point const& point, std::function<void()> const& fn,
+				   size_t n_samples) -> measurement {
+	using clock = std::chrono::steady_clock;
+
+	// the warmup doubles as calibration of the iterations in a sample
+	auto n_warmup = size_t(0);
+	const auto warmup_start = clock::now();
+	do {
+		fn();
+		++n_warmup;
+	} while (clock::now() - warmup_start < WARMUP_TIME);
+	const auto warmup_ns = f64(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - warmup_start).count());
+	const auto min_sample_ns =
+		f64(std::chrono::duration_cast<std::chrono::nanoseconds>(MIN_SAMPLE_TIME).count());
+	const auto iterations_per_sample =
+		std::max(size_t(1), size_t(std::ceil(min_sample_ns / (warmup_ns / f64(n_warmup)))));
+
+	auto result = measurement{
+		.name = name,
+		.point = point,
+		.iterations_per_sample = iterations_per_sample,
+		.ns_per_iteration = {},
+	};
+	for (auto sample = size_t(0); sample < n_samples; ++sample) {
+		const auto start = clock::now();
+		for (auto i = size_t(0); i < iterations_per_sample; ++i) {
+			fn();
+		}
+		const auto elapsed = clock::now() - start;
+		result.ns_per_iteration.push_back(
+			f64(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+			f64(iterations_per_sample));
+	}
+	return result;
+}
+
+// the first `relation_size` tuples of a fixed shuffle, always including the tuple of largest
+// values so that the relation spans the whole domain
+auto sample_relation(grid_point const& point) -> cspc::relation {
+	auto tuples = cspc::create_all_tuples(point.arity, point.domain_size);
+	std::swap(tuples.front(), tuples.back());
+	std::shuffle(tuples.begin() + 1, tuples.end(), std::mt19937(RELATION_SEED));
+	tuples.erase(
+		tuples.begin() + std::clamp(point.relation_size, size_t(1), tuples.size()), tuples.end());
+	return cspc::relation(tuples);
+}
+
+// every (arity, domain size) with the relation holding all tuples
+auto tuple_grid(std::vector<size_t> const& arities, std::vector<size_t> const& domain_sizes)
+	-> std::vector<grid_point> {
+	auto grid = std::vector<grid_point>{};
+	for (const auto n : arities) {
+		for (const auto d : domain_sizes) {
+			grid.push_back({n, d, (size_t)std::pow(d, n)});
+		}
+	}
+	return grid;
+}
+
+// relations of a quarter, half and three quarters of the tuples on small domains, where the
+// meta-CSP of a siggers operation stays small enough to build repeatedly
+auto relation_grid() -> std::vector<grid_point> {
+	auto grid = std::vector<grid_point>{};
+	const auto shapes = std::vector<std::pair<size_t, size_t>>{{2, 2}, {2, 3}, {2, 4}, {3, 2}};
+	for (auto const& [n, d] : shapes) {
+		const auto n_tuples = (size_t)std::pow(d, n);
+		for (const auto quarters : {1, 2, 3}) {
+			grid.push_back({n, d, std::max(size_t(1), n_tuples * quarters / 4)});
+		}
+	}
+	return grid;
+}
+
+// a clause generator timed on the siggers meta-CSP of a sampled relation, writing into a buffer
+// that is reused between iterations
+template <typename Generate>
+auto clause_benchmark(std::string name, Generate generate) -> benchmark {
+	return benchmark{
+		.name = std::move(name),
+		.grid = relation_grid(),
+		.setup =
+			[generate](grid_point const& point) -> std::function<void()> {
+			const auto csp = std::make_shared<cspc::csp>(cspc::construct_preserves_operation_csp(
+				cspc::siggers_operation(), sample_relation(point)));
+			const auto clauses = std::make_shared<std::vector<cspc::clause>>();
+			return [generate, csp, clauses]() {
+				clauses->clear();
+				generate(*csp, std::back_inserter(*clauses));
+				do_not_optimize(clauses->data());
+			};
+		},
+	};
+}
+
+auto benchmarks() -> std::vector<benchmark> {
+	using namespace cspc;
+	using output = std::back_insert_iterator<std::vector<clause>>;
+	const auto siggers_grid = [] {
+		auto grid = std::vector<grid_point>{};
+		for (const auto d : {2, 3, 4, 5}) {
+			grid.push_back({siggers_operation().arity, size_t(d), (size_t)std::pow(d, 4)});
+		}
+		return grid;
+	}();
+
+	auto result = std::vector<benchmark>{
+		{
+			"create_all_tuples",
+			tuple_grid({2, 3, 4}, {2, 3, 4}),
+			[](grid_point const& point) -> std::function<void()> {
+				return [point]() {
+					const auto tuples = create_all_tuples(point.arity, point.domain_size);
+					do_not_optimize(tuples);
+				};
+			},
+		},
+		{
+			"function_input_to_index",
+			tuple_grid({2, 3, 4}, {2, 3, 4}),
+			[](grid_point const& point) -> std::function<void()> {
+				const auto tuples = create_all_tuples(point.arity, point.domain_size);
+				return [tuples, point]() {
+					for (auto const& tuple : tuples) {
+						const auto index =
+							__internal::function_input_to_index(tuple, point.domain_size);
+						do_not_optimize(index);
+					}
+				};
+			},
+		},
+		{
+			"inverse",
+			relation_grid(),
+			[](grid_point const& point) -> std::function<void()> {
+				auto variables = std::vector<variable>(point.arity);
+				std::iota(variables.begin(), variables.end(), variable(0));
+				const auto _constraint = constraint(sample_relation(point), variables);
+				return [_constraint, point]() {
+					const auto result = inverse(_constraint, point.domain_size);
+					do_not_optimize(result);
+				};
+			},
+		},
+		{
+			// every function input of a siggers operation against the identity's first input
+			"satisfies_identity",
+			siggers_grid,
+			[](grid_point const& point) -> std::function<void()> {
+				const auto inputs = create_all_tuples(point.arity, point.domain_size);
+				const auto id = siggers_operation().identities[0].inputs[0];
+				return [inputs, id]() {
+					for (auto const& input : inputs) {
+						const auto satisfied = __internal::satisfies_identity(input, id);
+						do_not_optimize(satisfied);
+					}
+				};
+			},
+		},
+		{
+			"apply_identity",
+			siggers_grid,
+			[](grid_point const& point) -> std::function<void()> {
+				const auto inputs = create_all_tuples(point.arity, point.domain_size);
+				const auto identity = siggers_operation().identities[0];
+				const auto from = identity.inputs[0];
+				const auto to = identity.inputs[1];
+				return [inputs, from, to]() {
+					for (auto const& input : inputs) {
+						const auto mirror = __internal::apply_identity(input, from, to);
+						do_not_optimize(mirror);
+					}
+				};
+			},
+		},
+		{
+			// push_is_polymorphism_constraint for a siggers operation
+			"construct_is_polymorphism_constraints",
+			relation_grid(),
+			[](grid_point const& point) -> std::function<void()> {
+				const auto _relation = sample_relation(point);
+				return [_relation, point]() {
+					const auto constraints = __internal::construct_is_polymorphism_constraints(
+						_relation, point.domain_size, siggers_operation().arity);
+					do_not_optimize(constraints);
+				};
+			},
+		},
+	};
+
+	result.push_back(clause_benchmark("at_least_one_clauses", [](csp const& csp, output out) {
+		__internal::at_least_one_clauses(csp, out);
+	}));
+	result.push_back(clause_benchmark("at_most_one_clauses", [](csp const& csp, output out) {
+		__internal::at_most_one_clauses(csp, out);
+	}));
+	// nogoods are computed in the timed region, as every direct encoding does
+	result.push_back(clause_benchmark("conflict_clauses", [](csp const& csp, output out) {
+		const auto nogoods = __internal::nogoods(csp.constraints(), csp.domain_size());
+		__internal::conflict_clauses(nogoods, csp.domain_size(), out);
+	}));
+	result.push_back({
+		// the nogoods of a sampled relation over the bits of the binary encoding, values outside
+		// the domain left free as in the log encoding
+		"minimize_cover",
+		relation_grid(),
+		[](grid_point const& point) -> std::function<void()> {
+			const auto n_bits = __internal::n_bits(point.domain_size);
+			const auto width = point.arity * n_bits;
+			const auto encode = [&](relation_entry const& tuple) {
+				auto minterm = size_t(0);
+				for (auto j = size_t(0); j < point.arity; ++j) {
+					minterm |= size_t(tuple[j]) << (j * n_bits);
+				}
+				return minterm;
+			};
+			auto truth_table = std::vector<__internal::minterm_status>(
+				size_t(1) << width, __internal::MINTERM_ON);
+			for (auto const& tuple : create_all_tuples(point.arity, size_t(1) << n_bits)) {
+				if (std::ranges::any_of(tuple, [&](auto v) { return v >= point.domain_size; })) {
+					truth_table[encode(tuple)] = __internal::MINTERM_DC;
+				}
+			}
+			for (auto const& tuple : sample_relation(point)) {
+				truth_table[encode(tuple)] = __internal::MINTERM_OFF;
+			}
+			return [truth_table, width]() {
+				const auto cover = __internal::minimize_cover(truth_table, width);
+				do_not_optimize(cover);
+			};
+		},
+	});
+	result.push_back({
+		"nogood_cubes",
+		relation_grid(),
+		[](grid_point const& point) -> std::function<void()> {
+			const auto _relation = sample_relation(point);
+			return [_relation, point]() {
+				const auto cubes = __internal::nogood_cubes(
+					_relation, point.domain_size, __internal::n_bits(point.domain_size), false);
+				do_not_optimize(cubes);
+			};
+		},
+	});
+	result.push_back({
+		// the cubes of every constraint, minimized before the timed region, stamped out on its
+		// scope as the binary encoding does
+		"create_cube_clauses",
+		relation_grid(),
+		[](grid_point const& point) -> std::function<void()> {
+			const auto csp = construct_preserves_operation_csp(
+				siggers_operation(), sample_relation(point));
+			const auto n_bits = __internal::n_bits(csp.domain_size());
+			auto minimized =
+				std::unordered_map<relation, std::shared_ptr<std::vector<__internal::cube>>>{};
+			auto scoped_cubes = std::vector<
+				std::pair<std::shared_ptr<std::vector<__internal::cube>>, std::vector<variable>>>{};
+			for (auto const& constraint : csp.constraints()) {
+				auto& cubes = minimized[constraint.get_relation()];
+				if (cubes == nullptr) {
+					cubes = std::make_shared<std::vector<__internal::cube>>(
+						__internal::nogood_cubes(
+							constraint.get_relation(), csp.domain_size(), n_bits, false));
+				}
+				scoped_cubes.emplace_back(cubes, constraint.variables());
+			}
+			const auto clauses = std::make_shared<std::vector<clause>>();
+			return [scoped_cubes, n_bits, clauses]() {
+				clauses->clear();
+				for (auto const& [cubes, scope] : scoped_cubes) {
+					__internal::create_cube_clauses(
+						*cubes, scope, n_bits, std::back_inserter(*clauses));
+				}
+				do_not_optimize(clauses->data());
+			};
+		},
+	});
+	result.push_back(clause_benchmark("at_most_one_entry_clauses", [](csp const& csp, output out) {
+		__internal::at_most_one_entry_clauses(csp, out);
+	}));
+	result.push_back(clause_benchmark("at_least_one_entry_clauses", [](csp const& csp, output out) {
+		__internal::at_least_one_entry_clauses(csp, out);
+	}));
+	result.push_back(clause_benchmark("implication_clauses", [](csp const& csp, output out) {
+		__internal::implication_clauses(csp, out);
+	}));
+	return result;
+}
+
+auto to_json(std::vector<measurement> const& measurements) -> std::string {
+	auto json = std::string("[\n");
+	for (auto i = size_t(0); i < measurements.size(); ++i) {
+		auto const& m = measurements[i];
+		const auto s = summarize(m.ns_per_iteration);
+		json += fmt::format(
+			"  {{\"name\": \"{}\", \"arity\": {}, \"domain_size\": {}, \"relation_size\": {}, "
+			"\"iterations_per_sample\": {}, \"ns_per_iteration\": {{\"min\": {:.1f}, \"median\": "
+			"{:.1f}, \"mean\": {:.1f}, \"stddev\": {:.1f}}}, \"samples\": [{:.1f}]}}{}\n",
+			m.name, m.point.arity, m.point.domain_size, m.point.relation_size,
+			m.iterations_per_sample, s.min, s.median, s.mean, s.stddev,
+			fmt::join(m.ns_per_iteration, ", "), i + 1 < measurements.size() ? "," : "");
+	}
+	json += "]\n";
+	return json;
+}
+
+auto main(int argc, char* argv[]) -> int {
+	const auto args = std::vector<std::string>(argv + 1, argv + argc);
+	auto filter = std::string{};
+	auto n_samples = DEFAULT_N_SAMPLES;
+	auto json_path = std::optional<std::string>{};
+	for (auto i = size_t(0); i < args.size(); i += 2) {
+		if (i + 1 >= args.size()) {
+			spdlog::error("Missing value for {}", args[i]);
+			return EXIT_FAILURE;
+		}
+		if (args[i] == "--filter") {
+			filter = args[i + 1];
+		} else if (args[i] == "--samples") {
+			// throws
+			n_samples = std::max(std::stoul(args[i + 1]), 2ul);
+		} else if (args[i] == "--json") {
+			json_path = args[i + 1];
+		} else {
+			spdlog::error("Unknown argument {}", args[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	auto measurements = std::vector<measurement>{};
+	spdlog::info(
+		"{:40} {:>5} {:>6} {:>5} {:>14} {:>14} {:>8}", "Benchmark", "Arity", "Domain", "|R|",
+		"Median", "Min", "Stddev");
+	for (auto const& _benchmark : benchmarks()) {
+		if (_benchmark.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		for (auto const& point : _benchmark.grid) {
+			const auto fn = _benchmark.setup(point);
+			measurements.push_back(run_benchmark(_benchmark.name, point, fn, n_samples));
+			const auto s = summarize(measurements.back().ns_per_iteration);
+			spdlog::info(
+				"{:40} {:>5} {:>6} {:>5} {:>12.1f}ns {:>12.1f}ns {:>7.1f}%", _benchmark.name,
+				point.arity, point.domain_size, point.relation_size, s.median, s.min,
+				100.0 * s.stddev / s.mean);
+		}
+	}
+
+	if (json_path.has_value()) {
+		auto ofs = std::ofstream(json_path.value());
+		ofs << to_json(measurements);
+		if (!ofs) {
+			spdlog::error("Failed to write {}", json_path.value());
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/binary.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/encodings/label_cover.hpp>
+#include <cspc/kissat.hpp>
+#include <spdlog/spdlog.h>
+
+// usage:
+//   cspc_profiler_tune_kissat [<samples>]
+//     solves the encoded siggers meta-CSPs of every relation family with every kissat preset and
+//     reports the preset with the least total solve time per (encoding, family); encoding is
+//     done once up front so that only solving is timed, and the fastest of the samples is kept
+
+constexpr auto DEFAULT_N_SAMPLES = size_t{3};
+
+struct relation_family {
+	std::string name;
+	std::vector<cspc::relation> relations;
+};
+
+struct tuning_result {
+	std::string preset;
+	f64 total_ms;
+};
+
+auto relation_families() -> std::vector<relation_family> {
+	return {
+		{"All binary on domain [0, 2)", cspc::all_nary_relations(2, 2)},
+		{"All binary on domain [0, 3)", cspc::all_nary_relations(2, 3)},
+		{"All ternary on domain [0, 2)", cspc::all_nary_relations(3, 2)},
+		{"{!=} on domain [0, 4)", {cspc::neq_relation(2, 4)}},
+		{"{!=} on domain [0, 5)", {cspc::neq_relation(2, 5)}},
+	};
+}
+
+auto time_solving(cspc::solver const& solver, std::vector<cspc::sat> const& instances, size_t n_samples)
+	-> f64 {
+	auto best = std::chrono::nanoseconds::max();
+	for (auto sample = size_t(0); sample < n_samples; ++sample) {
+		const auto start = std::chrono::steady_clock::now();
+		for (auto const& instance : instances) {
+			solver(instance);
+		}
+		best = std::min(best, std::chrono::steady_clock::now() - start);
+	}
+	return f64(best.count()) / 1e6;
+}
+
+auto main(int argc, char* argv[]) -> int {
+	if (argc > 2) {
+		spdlog::error("Incorrect number of arguments");
+		return EXIT_FAILURE;
+	}
+	// throws
+	const auto n_samples = argc == 2 ? std::max(std::stoul(argv[1]), 1ul) : DEFAULT_N_SAMPLES;
+	const auto encodings = std::vector<std::pair<std::string, cspc::encoding>>{
+		{"Multivalued direct encoding", cspc::multivalued_direct_encoding},
+		{"Direct encoding", cspc::direct_encoding},
+		{"Log encoding", cspc::log_encoding},
+		{"Multivalued label cover encoding", cspc::multivalued_label_cover_encoding},
+	};
+	const auto families = relation_families();
+	const auto siggers = cspc::siggers_operation();
+
+	spdlog::info(
+		"{:34} {:30} {:>20} {:>12} {:>12} {:>8}", "Encoding", "Family", "Best preset", "Best",
+		"Default", "Speedup");
+	for (auto const& [encoding_name, encoding] : encodings) {
+		for (auto const& family : families) {
+			auto instances = std::vector<cspc::sat>{};
+			instances.reserve(family.relations.size());
+			std::ranges::transform(
+				family.relations, std::back_inserter(instances), [&](cspc::relation const& r) {
+					return encoding(cspc::construct_preserves_operation_csp(siggers, r));
+				});
+
+			auto results = std::vector<tuning_result>{};
+			for (auto const& preset : cspc::kissat_presets()) {
+				results.push_back(tuning_result{
+					.preset = preset.name,
+					.total_ms = time_solving(
+						cspc::create_kissat_solver(preset.options), instances, n_samples),
+				});
+			}
+			const auto best = std::ranges::min(results, {}, &tuning_result::total_ms);
+			const auto default_ms =
+				std::ranges::find(results, "default", &tuning_result::preset)->total_ms;
+			spdlog::info(
+				"{:34} {:30} {:>20} {:>10.2f}ms {:>10.2f}ms {:>7.2f}x", encoding_name, family.name,
+				best.preset, best.total_ms, default_ms, default_ms / best.total_ms);
+		}
+	}
+	return EXIT_SUCCESS;
+}
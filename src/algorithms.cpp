@@ -2,6 +2,8 @@
 
 #include "cspc/data_structures.hpp"
 #include "cspc/formatters.hpp"
+#include "cspc/metrics.hpp"
+#include <cassert>
 #include <fmt/core.h>
 #include <gautil/formatters.hpp>
 #include <gautil/functional.hpp>
@@ -9,6 +11,7 @@
 #include <numeric>
 #include <ranges>
 #include <spdlog/spdlog.h>
+#include <thread>
 
 namespace cspc {
 namespace __internal {
@@ -92,6 +95,10 @@ auto inverse(constraint const& _constraint, size_t domain_size) -> constraint {
 	inverse_relation.reserve(sorted_all_tuples.size() - sorted_constraint_relation.size());
 	std::ranges::set_difference(
 		sorted_all_tuples, sorted_constraint_relation, std::back_inserter(inverse_relation));
+	if (inverse_relation.empty()) {
+		// a full relation, such as equality on a single value, has no nogoods to find the arity of
+		return constraint(relation(_constraint.get_relation().arity()), _constraint.variables());
+	}
 	return constraint(std::move(inverse_relation), _constraint.variables());
 }
 
@@ -122,6 +129,31 @@ auto all_nary_relations(size_t n, size_t domain_size) -> std::vector<relation> {
 	return result;
 }
 
+auto gray_code_nary_relations(size_t n, size_t domain_size) -> std::vector<relation> {
+	auto tuples = std::vector<relation_entry>{};
+	std::ranges::copy_if(
+		create_all_tuples(n, domain_size), std::back_inserter(tuples),
+		[](relation_entry const& tuple) {
+			return std::ranges::adjacent_find(tuple, std::not_equal_to{}) != tuple.end();
+		});
+
+	// the i:th relation holds the tuples at the set bits of the reflected binary code of i
+	const auto n_relations = (size_t(1) << tuples.size()) - 1;
+	auto result = std::vector<relation>{};
+	result.reserve(n_relations);
+	for (auto i = size_t(1); i <= n_relations; ++i) {
+		const auto code = i ^ (i >> 1);
+		auto _relation = relation(n);
+		for (auto j = size_t(0); j < tuples.size(); ++j) {
+			if ((code >> j) & 1) {
+				_relation.insert(tuples[j]);
+			}
+		}
+		result.push_back(std::move(_relation));
+	}
+	return result;
+}
+
 auto neq_relation(size_t arity, size_t domain_size) -> relation {
 	return create_relation<relation_entry>(arity, domain_size, [](relation_entry const& range) {
 		return std::ranges::adjacent_find(range, std::not_equal_to()) != range.end();
@@ -136,55 +168,125 @@ auto eq_relation(size_t arity, size_t domain_size) -> relation {
 
 auto siggers_operation() -> operation { return operation(4, {{{0, 1, 0, 2}, {1, 0, 2, 1}}}); }
 
+// m(x, x, y) = m(x, y, x) = m(y, x, x) = x
+auto majority_operation() -> operation {
+	return operation(3, {{{{0, 0, 1}, {0, 1, 0}, {1, 0, 0}}, {0}}});
+}
+
+// p(x, x, y) = p(y, x, x) = y
+auto maltsev_operation() -> operation { return operation(3, {{{{0, 0, 1}, {1, 0, 0}}, {1}}}); }
+
+// c(x_0, x_1, ..., x_n) = c(x_1, ..., x_n, x_0)
+auto cyclic_operation(size_t arity) -> operation {
+	assert(arity > 0);
+	auto inputs = std::vector<variable>(arity);
+	std::iota(inputs.begin(), inputs.end(), variable(0));
+	auto rotated = inputs;
+	std::ranges::rotate(rotated, rotated.begin() + 1);
+	return operation(arity, {identity({inputs, rotated})});
+}
+
 namespace __internal {
+// the constraints of a meta-CSP all copy a few relations, so each is sorted once beforehand and
+// the encodings compare and hash the copies without sorting each of them again
+auto sorted_relation(relation _relation) -> relation {
+	_relation.sort();
+	return _relation;
+}
+
+// the constraints of the function table entries [begin, end) of every identity in turn, where
+// entry i of the concatenated tables is entry i % d^arity of identity i / d^arity
 template <std::output_iterator<constraint> OutputIterator>
-auto push_operation_identity_constraints(
-	operation const& operation, size_t domain_size, OutputIterator result) -> OutputIterator {
+auto push_identity_table_constraints(
+	operation const& operation, size_t domain_size, size_t begin, size_t end, OutputIterator result)
+	-> OutputIterator {
 	const auto function_table_entries = (u32)std::pow(domain_size, operation.arity);
-	const auto eq = eq_relation(2, domain_size);
-	std::ranges::for_each(operation.identities, [&](auto const& identity) {
-		for (auto k = variable(0); k < function_table_entries; ++k) {
-			const auto input = __internal::index_to_function_input(k, operation.arity, domain_size);
-			for (auto i = size_t(0); i < identity.inputs.size(); ++i) {
-				if (!__internal::satisfies_identity(input, identity.inputs[i])) {
-					continue;
-				}
+	const auto eq = sorted_relation(eq_relation(2, domain_size));
+	for (auto entry = begin; entry < end; ++entry) {
+		auto const& identity = operation.identities[entry / function_table_entries];
+		const auto k = variable(entry % function_table_entries);
+		const auto input = __internal::index_to_function_input(k, operation.arity, domain_size);
+		for (auto i = size_t(0); i < identity.inputs.size(); ++i) {
+			if (!__internal::satisfies_identity(input, identity.inputs[i])) {
+				continue;
+			}
 
-				// function input = function input
-				for (auto j = i + 1; j < identity.inputs.size(); ++j) {
-					const auto mirror =
-						__internal::apply_identity(input, identity.inputs[i], identity.inputs[j]);
-					const auto k_mirror = __internal::function_input_to_index(mirror, domain_size);
-					*result++ = constraint{eq, {k, k_mirror}};
-				}
+			// function input = function input
+			for (auto j = i + 1; j < identity.inputs.size(); ++j) {
+				const auto mirror =
+					__internal::apply_identity(input, identity.inputs[i], identity.inputs[j]);
+				const auto k_mirror = __internal::function_input_to_index(mirror, domain_size);
+				*result++ = constraint{eq, {k, k_mirror}};
+			}
 
-				// function input = variable
-				for (auto j = size_t(0); j < identity.variables.size(); ++j) {
-					const auto it = std::ranges::find(identity.inputs[i], identity.variables[j]);
-					if (it == identity.inputs[i].end()) {
-						continue;
-					}
-					const auto index = std::distance(identity.inputs[i].begin(), it);
-					const auto var_csp_var = function_table_entries + input[index];
-					*result++ = {eq, {k, var_csp_var}};
+			// function input = variable
+			for (auto j = size_t(0); j < identity.variables.size(); ++j) {
+				const auto it = std::ranges::find(identity.inputs[i], identity.variables[j]);
+				if (it == identity.inputs[i].end()) {
+					continue;
 				}
+				const auto index = std::distance(identity.inputs[i].begin(), it);
+				const auto var_csp_var = function_table_entries + input[index];
+				*result++ = {eq, {k, var_csp_var}};
 			}
 		}
-	});
+	}
 	return result;
 }
 
 template <std::output_iterator<constraint> OutputIterator>
-auto push_is_polymorphism_constraint(
-	relation const& _relation, size_t domain_size, size_t operation_arity, OutputIterator result)
-	-> OutputIterator {
+auto push_identity_variable_constraints(
+	operation const& operation, size_t domain_size, OutputIterator result) -> OutputIterator {
+	// the csp variable following the function table at offset a stands for the domain value a
+	const auto function_table_entries = (u32)std::pow(domain_size, operation.arity);
+	const auto has_variables = std::ranges::any_of(
+		operation.identities, [](auto const& identity) { return !identity.variables.empty(); });
+	if (has_variables) {
+		for (auto a = domain_value(0); a < domain_size; ++a) {
+			*result++ = constraint{
+				sorted_relation(relation{relation_entry{a}}), {function_table_entries + a}, IS};
+		}
+	}
+	return result;
+}
+
+auto n_identity_table_entries(operation const& operation, size_t domain_size) -> size_t {
+	return operation.identities.size() * (size_t)std::pow(domain_size, operation.arity);
+}
+
+template <std::output_iterator<constraint> OutputIterator>
+auto push_operation_identity_constraints(
+	operation const& operation, size_t domain_size, OutputIterator result) -> OutputIterator {
+	result = push_identity_table_constraints(
+		operation, domain_size, 0, n_identity_table_entries(operation, domain_size), result);
+	return push_identity_variable_constraints(operation, domain_size, result);
+}
+
+// the constraints of the row choices [begin, end), where choice i picks row (i / |R|^k) % |R| of
+// the relation for the k-th operation input
+template <std::output_iterator<constraint> OutputIterator>
+auto push_is_polymorphism_constraints(
+	relation const& _relation,
+	size_t domain_size,
+	size_t operation_arity,
+	size_t begin,
+	size_t end,
+	OutputIterator result) -> OutputIterator {
 	const auto n_indices = _relation.size();
-	const auto n_iterations = (size_t)std::pow(n_indices, operation_arity);
 	// constraints from operation being polymorphism of all relations
+	if (begin == end) {
+		return result;
+	}
 
-	// for each choice of rows in relation
+	// decoded directly, so that a range can start anywhere
 	auto current_relation_indices = relation_entry(operation_arity);
-	gautil::repeat(n_iterations, [&]() {
+	auto remaining = begin;
+	for (auto& index : current_relation_indices) {
+		index = domain_value(remaining % n_indices);
+		remaining /= n_indices;
+	}
+	// for each choice of rows in relation
+	gautil::repeat(end - begin, [&]() {
 		// extract each column by index in the set of rows and get its index in the function
 		// table
 		auto indices = std::vector<variable>(_relation.arity());
@@ -203,24 +305,120 @@ auto push_is_polymorphism_constraint(
 	return result;
 }
 
+template <std::output_iterator<constraint> OutputIterator>
+auto push_is_polymorphism_constraint(
+	relation const& _relation, size_t domain_size, size_t operation_arity, OutputIterator result)
+	-> OutputIterator {
+	const auto n_iterations = (size_t)std::pow(_relation.size(), operation_arity);
+	return push_is_polymorphism_constraints(
+		_relation, domain_size, operation_arity, 0, n_iterations, result);
+}
+
+// appends push(begin, end, out) over [0, n) split into n_threads contiguous ranges, each pushed
+// into its own buffer on its own thread, in the order of the ranges
+template <typename Push>
+auto push_in_parallel(std::vector<constraint>& constraints, size_t n, size_t n_threads, Push push)
+	-> void {
+	n_threads = std::clamp(n_threads, size_t(1), std::max(n, size_t(1)));
+	auto buffers = std::vector<std::vector<constraint>>(n_threads);
+	const auto push_range = [&](size_t t) {
+		push(n * t / n_threads, n * (t + 1) / n_threads, std::back_inserter(buffers[t]));
+	};
+	{
+		auto threads = std::vector<std::jthread>{};
+		threads.reserve(n_threads - 1);
+		for (auto t = size_t(1); t < n_threads; ++t) {
+			threads.emplace_back(push_range, t);
+		}
+		push_range(0);
+	}
+	const auto n_pushed =
+		gautil::fold(buffers, size_t(0), std::plus{}, &std::vector<constraint>::size);
+	constraints.reserve(constraints.size() + n_pushed);
+	for (auto& buffer : buffers) {
+		std::ranges::move(buffer, std::back_inserter(constraints));
+	}
+}
+
 auto find_relation_domain_size(relation const& _relation) -> size_t {
 	return 1 + gautil::fold(_relation, size_t(0), [](auto const& largest, auto const& entry) {
 			   return std::max(largest, size_t(std::ranges::max(entry)));
 		   });
 }
+
+auto find_language_domain_size(constraint_language const& language) -> size_t {
+	return gautil::fold(language, size_t(1), [](size_t largest, relation const& _relation) {
+		return _relation.empty() ? largest
+								 : std::max(largest, find_relation_domain_size(_relation));
+	});
+}
+
+auto construct_operation_identity_constraints(operation const& _operation, size_t domain_size)
+	-> std::vector<constraint> {
+	auto constraints = std::vector<constraint>{};
+	push_operation_identity_constraints(_operation, domain_size, std::back_inserter(constraints));
+	return constraints;
+}
+
+auto construct_is_polymorphism_constraints(
+	relation const& _relation, size_t domain_size, size_t operation_arity)
+	-> std::vector<constraint> {
+	const auto sorted = sorted_relation(_relation);
+	auto constraints = std::vector<constraint>{};
+	constraints.reserve(std::pow(sorted.size(), operation_arity));
+	push_is_polymorphism_constraint(
+		sorted, domain_size, operation_arity, std::back_inserter(constraints));
+	return constraints;
+}
 } // namespace __internal
 
-auto construct_preserves_operation_csp(operation const& _operation, relation const& _relation)
-	-> csp {
-	const auto domain_size = __internal::find_relation_domain_size(_relation);
+auto construct_preserves_operation_csp(
+	operation const& _operation, relation const& _relation, size_t n_threads) -> csp {
+	return construct_preserves_operation_csp(_operation, constraint_language{_relation}, n_threads);
+}
+
+auto construct_preserves_operation_csp(
+	operation const& _operation, constraint_language const& language, size_t n_threads) -> csp {
+	static auto& construction_time = global_metrics().histogram(
+		"cspc_construct_csp_seconds", "Time taken to construct the meta-CSP of a relation",
+		METRIC_SECONDS);
+	const auto timer = scoped_timer(construction_time);
+
+	const auto domain_size = __internal::find_language_domain_size(language);
+	auto sorted_language = constraint_language{};
+	std::ranges::transform(
+		language, std::back_inserter(sorted_language), __internal::sorted_relation);
 
 	auto constraints = std::vector<constraint>{};
 
-	__internal::push_operation_identity_constraints(
-		_operation, domain_size, std::back_inserter(constraints));
+	if (n_threads <= 1) {
+		__internal::push_operation_identity_constraints(
+			_operation, domain_size, std::back_inserter(constraints));
+
+		for (auto const& _relation : sorted_language) {
+			__internal::push_is_polymorphism_constraint(
+				_relation, domain_size, _operation.arity, std::back_inserter(constraints));
+		}
 
-	__internal::push_is_polymorphism_constraint(
-		_relation, domain_size, _operation.arity, std::back_inserter(constraints));
+		return csp(std::move(constraints));
+	}
+
+	// the same constraints in the same order as the serial construction
+	__internal::push_in_parallel(
+		constraints, __internal::n_identity_table_entries(_operation, domain_size), n_threads,
+		[&](size_t begin, size_t end, auto out) {
+			__internal::push_identity_table_constraints(_operation, domain_size, begin, end, out);
+		});
+	__internal::push_identity_variable_constraints(
+		_operation, domain_size, std::back_inserter(constraints));
+	for (auto const& _relation : sorted_language) {
+		__internal::push_in_parallel(
+			constraints, (size_t)std::pow(_relation.size(), _operation.arity), n_threads,
+			[&](size_t begin, size_t end, auto out) {
+				__internal::push_is_polymorphism_constraints(
+					_relation, domain_size, _operation.arity, begin, end, out);
+			});
+	}
 
 	return csp(std::move(constraints));
 }
@@ -0,0 +1,104 @@
+#include "cspc/context.hpp"
+
+#include "cspc/algorithms.hpp"
+#include "cspc/metrics.hpp"
+#include <cmath>
+
+namespace cspc {
+classification_context::classification_context(operation const& _operation, encoding _encoding)
+	: m_operation{_operation}, m_encoding{std::move(_encoding)}, m_choice(_operation.arity) {}
+
+auto classification_context::identity_clauses(size_t domain_size) -> std::vector<i32> const& {
+	if (m_identity_clauses.size() <= domain_size) {
+		m_identity_clauses.resize(domain_size + 1);
+	}
+	auto& cached = m_identity_clauses[domain_size];
+	if (!cached.has_value()) {
+		// the function table followed by one variable per domain value
+		const auto n_variables = (size_t)std::pow(domain_size, m_operation.arity) + domain_size;
+		const auto encoded = m_encoding(csp(
+			__internal::construct_operation_identity_constraints(m_operation, domain_size),
+			n_variables, domain_size));
+		cached.emplace();
+		for (auto const& _clause : encoded.clauses()) {
+			std::ranges::transform(_clause, std::back_inserter(cached.value()), [](literal lit) {
+				return i32(lit.value);
+			});
+			cached->push_back(0);
+		}
+	}
+	return cached.value();
+}
+
+auto classification_context::encode(relation const& _relation) -> flat_clauses {
+	// construction and encoding are fused here, so they are reported as one encoding
+	static const auto metrics = __internal::create_encoding_metrics("context");
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto domain_size = __internal::find_relation_domain_size(_relation);
+	const auto arity = _relation.arity();
+	const auto n_rows = _relation.size();
+	const auto n_tuples = (size_t)std::pow(domain_size, arity);
+
+	m_clauses.clear();
+	std::ranges::copy(identity_clauses(domain_size), std::back_inserter(m_clauses));
+	if (n_rows == 0) {
+		metrics.clauses.record(u64(std::ranges::count(m_clauses, 0)));
+		return m_clauses;
+	}
+
+	m_contains.assign(n_tuples, false);
+	for (auto const& entry : _relation) {
+		m_contains[__internal::function_input_to_index(entry, domain_size)] = true;
+	}
+
+	// one conflict clause per choice of rows and tuple outside of the relation, as in
+	// construct_preserves_operation_csp followed by a direct encoding
+	m_scope.resize(arity);
+	std::ranges::fill(m_choice, 0);
+	const auto n_iterations = (size_t)std::pow(n_rows, m_operation.arity);
+	for (auto iteration = size_t(0); iteration < n_iterations; ++iteration) {
+		std::ranges::fill(m_scope, 0);
+		for (auto const row : m_choice) {
+			for (auto j = size_t(0); j < arity; ++j) {
+				m_scope[j] = m_scope[j] * domain_size + _relation[row][j];
+			}
+		}
+		for (auto nogood = size_t(0); nogood < n_tuples; ++nogood) {
+			if (m_contains[nogood]) {
+				continue;
+			}
+			// the digits of the nogood, most significant first
+			auto place = n_tuples / domain_size;
+			for (auto j = size_t(0); j < arity; ++j) {
+				const auto value = nogood / place % domain_size;
+				place /= domain_size;
+				m_clauses.push_back(-i32(m_scope[j] * domain_size + value + 1));
+			}
+			m_clauses.push_back(0);
+		}
+
+		for (auto& row : m_choice) {
+			if (++row < n_rows) {
+				break;
+			}
+			row = 0;
+		}
+	}
+	metrics.clauses.record(u64(std::ranges::count(m_clauses, 0)));
+	return m_clauses;
+}
+
+auto classification_context::classify(relation const& _relation, flat_solver const& _solver)
+	-> satisfiability {
+	return _solver(encode(_relation));
+}
+
+auto create_context_solver(operation const& _operation, encoding _encoding, flat_solver _solver)
+	-> polymorphism_checker {
+	const auto context = std::make_shared<classification_context>(_operation, _encoding);
+	return [context, _solver](relation const& _relation) {
+		return context->classify(_relation, _solver);
+	};
+}
+} // namespace cspc
@@ -0,0 +1,161 @@
+#include "cspc/core.hpp"
+
+#include "cspc/algorithms.hpp"
+#include "cspc/metrics.hpp"
+#include <cmath>
+
+namespace cspc {
+namespace __internal {
+auto find_endomorphism_avoiding(
+	relation const& _relation, size_t domain_size, domain_value excluded)
+	-> std::optional<std::vector<domain_value>> {
+	const auto arity = _relation.arity();
+	auto contains = std::vector<bool>((size_t)std::pow(domain_size, arity));
+	for (auto const& entry : _relation) {
+		contains[function_input_to_index(entry, domain_size)] = true;
+	}
+	// a tuple can be checked once its largest value is mapped, and values are mapped in order
+	auto checked_at = std::vector<std::vector<size_t>>(domain_size);
+	for (auto i = size_t(0); i < _relation.size(); ++i) {
+		checked_at[std::ranges::max(_relation[i])].push_back(i);
+	}
+
+	auto map = std::vector<domain_value>(domain_size);
+	auto image = relation_entry(arity);
+	const auto consistent = [&](domain_value a) {
+		return std::ranges::all_of(checked_at[a], [&](size_t i) {
+			for (auto j = size_t(0); j < arity; ++j) {
+				image[j] = map[_relation[i][j]];
+			}
+			return bool(contains[function_input_to_index(image, domain_size)]);
+		});
+	};
+	// depth first over the values of map[a], ..., map[domain_size - 1]
+	const auto search = [&](auto const& self, domain_value a) -> bool {
+		if (a == domain_size) {
+			return true;
+		}
+		for (auto b = domain_value(0); b < domain_size; ++b) {
+			if (b == excluded) {
+				continue;
+			}
+			map[a] = b;
+			if (consistent(a) && self(self, a + 1)) {
+				return true;
+			}
+		}
+		return false;
+	};
+	return search(search, 0) ? std::optional{map} : std::nullopt;
+}
+
+// the image of the relation under the map, with the values of the image renumbered from 0
+auto retract(relation const& _relation, std::vector<domain_value> const& map) -> relation {
+	auto used = std::vector<bool>(map.size(), false);
+	for (const auto value : map) {
+		used[value] = true;
+	}
+	auto renumbered = std::vector<domain_value>(map.size());
+	auto next = domain_value(0);
+	for (auto value = size_t(0); value < map.size(); ++value) {
+		renumbered[value] = next;
+		next += used[value] ? 1 : 0;
+	}
+
+	auto entries = std::vector<relation_entry>{};
+	entries.reserve(_relation.size());
+	for (auto const& entry : _relation) {
+		auto image = relation_entry(entry.size());
+		for (auto j = size_t(0); j < entry.size(); ++j) {
+			image[j] = renumbered[map[entry[j]]];
+		}
+		entries.push_back(std::move(image));
+	}
+	std::ranges::sort(entries);
+	const auto [first, last] = std::ranges::unique(entries);
+	entries.erase(first, last);
+	return relation(std::move(entries));
+}
+} // namespace __internal
+
+auto find_core(relation const& _relation) -> relation {
+	static auto& core_time = global_metrics().histogram(
+		"cspc_find_core_seconds", "Time taken to find the core of a relation", METRIC_SECONDS);
+	const auto timer = scoped_timer(core_time);
+
+	if (_relation.empty()) {
+		return _relation;
+	}
+	auto core = _relation;
+	auto shrunk = true;
+	while (shrunk) {
+		shrunk = false;
+		const auto domain_size = __internal::find_relation_domain_size(core);
+		for (auto excluded = domain_value(0); excluded < domain_size; ++excluded) {
+			const auto map = __internal::find_endomorphism_avoiding(core, domain_size, excluded);
+			if (map.has_value()) {
+				core = __internal::retract(core, map.value());
+				shrunk = true;
+				break;
+			}
+		}
+	}
+	return core;
+}
+
+auto construct_idempotent_preserves_operation_csp(
+	operation const& _operation, relation const& core) -> csp {
+	const auto domain_size = __internal::find_relation_domain_size(core);
+	auto constraints = construct_preserves_operation_csp(_operation, core).constraints();
+	// f(a, ..., a) = a
+	for (auto a = domain_value(0); a < domain_size; ++a) {
+		auto input = relation_entry(_operation.arity);
+		std::ranges::fill(input, a);
+		const auto k = __internal::function_input_to_index(input, domain_size);
+		constraints.push_back(constraint{relation{relation_entry{a}}, {variable(k)}, IS});
+	}
+	return csp(constraints);
+}
+
+auto core_cache::find(relation const& _relation) -> relation {
+	{
+		const auto lock = std::scoped_lock(m_mutex);
+		const auto it = m_positions.find(_relation);
+		if (it != m_positions.end()) {
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			m_cores.splice(m_cores.begin(), m_cores, it->second);
+			return it->second->second;
+		}
+	}
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+	auto core = find_core(_relation);
+	const auto lock = std::scoped_lock(m_mutex);
+	// another thread may have found the same core meanwhile
+	if (m_capacity == 0 || m_positions.contains(_relation)) {
+		return core;
+	}
+	m_cores.emplace_front(_relation, core);
+	m_positions.emplace(_relation, m_cores.begin());
+	if (m_cores.size() > m_capacity) {
+		m_positions.erase(m_cores.back().first);
+		m_cores.pop_back();
+	}
+	return core;
+}
+
+auto create_core_encoding_solver(
+	operation const& _operation,
+	encoding _encoding,
+	solver _solver,
+	std::shared_ptr<core_cache> cache) -> polymorphism_checker {
+	const auto binds_variables = std::ranges::any_of(
+		_operation.identities, [](auto const& identity) { return !identity.variables.empty(); });
+	if (binds_variables) {
+		return create_encoding_solver(_operation, std::move(_encoding), std::move(_solver));
+	}
+	return [_operation, _encoding, _solver, cache](relation const& _relation) {
+		const auto core = cache->find(_relation);
+		return _solver(_encoding(construct_idempotent_preserves_operation_csp(_operation, core)));
+	};
+}
+} // namespace cspc
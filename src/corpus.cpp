@@ -0,0 +1,191 @@
+#include "cspc/corpus.hpp"
+
+#include "cspc/algorithms.hpp"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cspc {
+namespace __internal {
+constexpr auto CORPUS_MAGIC = std::string_view("CSPCREL1");
+constexpr auto CORPUS_VERSION = u32{1};
+constexpr auto CORPUS_HEADER_SIZE = size_t{64};
+
+struct corpus_header {
+	char magic[8];
+	u32 version;
+	u32 arity;
+	u32 domain_size;
+	u32 tuple_bits;
+	u64 n_relations;
+	u64 offsets_position;
+};
+static_assert(sizeof(corpus_header) <= CORPUS_HEADER_SIZE);
+static_assert(std::endian::native == std::endian::little, "corpora are little endian");
+
+auto corpus_tuple_bits(size_t arity, size_t domain_size) -> u32 {
+	const auto n_tuples = (u64)std::pow(domain_size, arity);
+	return std::max(u32(1), u32(std::bit_width(n_tuples - 1)));
+}
+} // namespace __internal
+
+auto relation_view::entry(size_t i) const -> relation_entry {
+	return __internal::index_to_function_input(tuple_index(i), m_arity, m_domain_size);
+}
+
+auto relation_view::to_relation() const -> relation {
+	auto result = relation(m_arity);
+	result.reserve(m_n_tuples);
+	for (auto i = size_t(0); i < m_n_tuples; ++i) {
+		result.insert(entry(i));
+	}
+	return result;
+}
+
+relation_corpus::~relation_corpus() { munmap(m_mapping, m_mapping_size); }
+
+auto relation_corpus::open(std::filesystem::path const& path) -> std::unique_ptr<relation_corpus> {
+	const auto fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		spdlog::error("Failed to open {}: {}", path.string(), strerror(errno));
+		return nullptr;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		spdlog::error("Failed to stat {}: {}", path.string(), strerror(errno));
+		::close(fd);
+		return nullptr;
+	}
+	const auto file_size = size_t(status.st_size);
+	if (file_size < __internal::CORPUS_HEADER_SIZE) {
+		spdlog::error("{} is too small to be a relation corpus", path.string());
+		::close(fd);
+		return nullptr;
+	}
+	auto* mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping stays valid after the file is closed
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		spdlog::error("Failed to map {}: {}", path.string(), strerror(errno));
+		return nullptr;
+	}
+	auto result = std::unique_ptr<relation_corpus>(new relation_corpus(mapping, file_size));
+
+	auto header = __internal::corpus_header{};
+	std::memcpy(&header, mapping, sizeof(header));
+	if (std::string_view(header.magic, sizeof(header.magic)) != __internal::CORPUS_MAGIC ||
+		header.version != __internal::CORPUS_VERSION) {
+		spdlog::error(
+			"{} is not a version {} relation corpus", path.string(), __internal::CORPUS_VERSION);
+		return nullptr;
+	}
+	if (header.arity == 0 || header.domain_size == 0 ||
+		header.tuple_bits != __internal::corpus_tuple_bits(header.arity, header.domain_size)) {
+		spdlog::error("Invalid arity, domain size or tuple width in {}", path.string());
+		return nullptr;
+	}
+	if (header.offsets_position % sizeof(u64) != 0 ||
+		header.offsets_position < __internal::CORPUS_HEADER_SIZE ||
+		header.offsets_position > file_size ||
+		(file_size - header.offsets_position) / sizeof(u64) < header.n_relations + 1) {
+		spdlog::error("Truncated offset index in {}", path.string());
+		return nullptr;
+	}
+
+	const auto* bytes = static_cast<char const*>(mapping);
+	result->m_arity = header.arity;
+	result->m_domain_size = header.domain_size;
+	result->m_tuple_bits = header.tuple_bits;
+	result->m_n_relations = header.n_relations;
+	result->m_words = reinterpret_cast<u64 const*>(bytes + __internal::CORPUS_HEADER_SIZE);
+	result->m_offsets = reinterpret_cast<u64 const*>(bytes + header.offsets_position);
+
+	// every relation must lie within the tuple data
+	const auto data_bits = (header.offsets_position - __internal::CORPUS_HEADER_SIZE) * 8;
+	const auto n_tuples = result->m_offsets[header.n_relations];
+	if (!std::ranges::is_sorted(result->m_offsets, result->m_offsets + header.n_relations + 1) ||
+		n_tuples > data_bits / header.tuple_bits) {
+		spdlog::error("Corrupt offset index in {}", path.string());
+		return nullptr;
+	}
+	madvise(mapping, file_size, MADV_RANDOM);
+	return result;
+}
+
+auto write_relation_corpus(
+	std::filesystem::path const& path,
+	size_t arity,
+	size_t domain_size,
+	std::vector<relation> const& relations) -> bool {
+	auto ofs = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	if (!ofs) {
+		spdlog::error("Failed to open {}", path.string());
+		return false;
+	}
+	// the header is written last, so a file that is cut short is never mistaken for a corpus
+	const auto padding = std::vector<char>(__internal::CORPUS_HEADER_SIZE);
+	ofs.write(padding.data(), padding.size());
+
+	const auto tuple_bits = __internal::corpus_tuple_bits(arity, domain_size);
+	auto offsets = std::vector<u64>{0};
+	offsets.reserve(relations.size() + 1);
+	auto words = std::vector<u64>{};
+	auto word = u64(0);
+	auto n_bits = u32(0); // bits of `word` in use
+	for (auto const& _relation : relations) {
+		for (auto const& entry : _relation) {
+			if (entry.size() != arity || std::ranges::any_of(entry, [&](domain_value value) {
+					return value >= domain_size;
+				})) {
+				spdlog::error(
+					"Tuple does not fit a corpus of arity {} on domain {}", arity, domain_size);
+				return false;
+			}
+			const auto index = u64(__internal::function_input_to_index(entry, domain_size));
+			word |= index << n_bits;
+			n_bits += tuple_bits;
+			if (n_bits >= 64) {
+				words.push_back(word);
+				n_bits -= 64;
+				word = n_bits > 0 ? index >> (tuple_bits - n_bits) : 0;
+			}
+		}
+		offsets.push_back(offsets.back() + _relation.size());
+		// write in chunks to keep memory bounded for large corpora
+		if (words.size() >= 1 << 16) {
+			ofs.write(reinterpret_cast<char const*>(words.data()), words.size() * sizeof(u64));
+			words.clear();
+		}
+	}
+	if (n_bits > 0) {
+		words.push_back(word);
+	}
+	ofs.write(reinterpret_cast<char const*>(words.data()), words.size() * sizeof(u64));
+
+	auto header = __internal::corpus_header{
+		.magic = {},
+		.version = __internal::CORPUS_VERSION,
+		.arity = u32(arity),
+		.domain_size = u32(domain_size),
+		.tuple_bits = tuple_bits,
+		.n_relations = relations.size(),
+		.offsets_position = u64(ofs.tellp()),
+	};
+	std::ranges::copy(__internal::CORPUS_MAGIC, header.magic);
+	ofs.write(reinterpret_cast<char const*>(offsets.data()), offsets.size() * sizeof(u64));
+	ofs.seekp(0);
+	ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	ofs.close();
+	if (!ofs) {
+		spdlog::error("Failed to write {}", path.string());
+		return false;
+	}
+	return true;
+}
+} // namespace cspc
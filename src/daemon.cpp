@@ -0,0 +1,340 @@
+#include "cspc/daemon.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <gautil/system.hpp>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace cspc {
+namespace __internal {
+static_assert(std::endian::native == std::endian::little, "the daemon protocol is little endian");
+
+constexpr auto DAEMON_REQUEST_HEADER_SIZE = 3 * sizeof(u32);
+constexpr auto DAEMON_ANSWER_SIZE = sizeof(u32) + sizeof(u8);
+
+// reads a socket in large chunks, so that pipelined messages cost one system call per chunk
+class socket_reader {
+  public:
+	socket_reader(int fd) : m_fd{fd} {}
+
+	// false on end of stream or error
+	auto read(void* data, size_t size) -> bool {
+		auto* bytes = static_cast<char*>(data);
+		while (size > 0) {
+			if (m_begin == m_end) {
+				const auto n_read = ::recv(m_fd, m_buffer.data(), m_buffer.size(), 0);
+				if (n_read < 0 && errno == EINTR) {
+					continue;
+				}
+				if (n_read <= 0) {
+					return false;
+				}
+				m_begin = 0;
+				m_end = size_t(n_read);
+			}
+			const auto n_copied = std::min(size, m_end - m_begin);
+			std::memcpy(bytes, m_buffer.data() + m_begin, n_copied);
+			m_begin += n_copied;
+			bytes += n_copied;
+			size -= n_copied;
+		}
+		return true;
+	}
+
+  private:
+	int m_fd;
+	std::array<char, 1 << 16> m_buffer;
+	size_t m_begin{0};
+	size_t m_end{0};
+};
+
+// a client connection, closed once its reader and every pending job are done with it
+class daemon_connection {
+  public:
+	daemon_connection(int fd) : m_fd{fd}, m_reader(fd) {}
+	daemon_connection(daemon_connection const&) = delete;
+	auto operator=(daemon_connection const&) -> daemon_connection& = delete;
+	~daemon_connection() { ::close(m_fd); }
+
+	// only called from the connection's reader thread
+	auto read(void* data, size_t size) -> bool { return m_reader.read(data, size); }
+	// answers may come from any worker thread
+	auto answer(u32 id, u8 result) -> void {
+		auto message = std::array<char, DAEMON_ANSWER_SIZE>{};
+		std::memcpy(message.data(), &id, sizeof(id));
+		message[sizeof(id)] = char(result);
+		const auto lock = std::scoped_lock(m_write_mutex);
+		gautil::send_all(m_fd, message.data(), message.size());
+	}
+	// wakes a reader blocked on the connection
+	auto shutdown() -> void { ::shutdown(m_fd, SHUT_RDWR); }
+
+  private:
+	int m_fd;
+	std::mutex m_write_mutex;
+	socket_reader m_reader;
+};
+} // namespace __internal
+
+classification_daemon::classification_daemon(
+	std::function<polymorphism_checker()> create_checker, daemon_options const& options)
+	: m_options{options},
+	  m_requests_metric{global_metrics().counter(
+		  "cspc_daemon_requests_total", "Requests received by the classification daemon")},
+	  m_cache_hits_metric{global_metrics().counter(
+		  "cspc_daemon_cache_hits_total", "Requests answered from the daemon's result cache")},
+	  m_queue_depth_metric{global_metrics().gauge(
+		  "cspc_daemon_queue_depth", "Requests waiting for a daemon worker")},
+	  m_latency_metric{global_metrics().histogram(
+		  "cspc_daemon_request_seconds", "Time from receiving a request to answering it",
+		  METRIC_SECONDS)} {
+	for (auto i = size_t(0); i < std::max(options.n_threads, size_t(1)); ++i) {
+		m_workers.emplace_back([this, checker = create_checker()](std::stop_token stop) {
+			work_loop(stop, checker);
+		});
+	}
+}
+
+classification_daemon::~classification_daemon() { stop(); }
+
+auto classification_daemon::listen(std::filesystem::path const& path) -> bool {
+	const auto fd = gautil::listen_unix_socket(path);
+	if (!fd.has_value()) {
+		return false;
+	}
+	m_path = path;
+	m_listen_fd = fd.value();
+	m_acceptor = std::jthread([this](std::stop_token stop) { accept_loop(stop); });
+	return true;
+}
+
+auto classification_daemon::stop() -> void {
+	if (m_listen_fd >= 0) {
+		m_acceptor.request_stop();
+		::shutdown(m_listen_fd, SHUT_RDWR);
+		m_acceptor.join();
+		::close(m_listen_fd);
+		m_listen_fd = -1;
+		auto error = std::error_code{};
+		std::filesystem::remove(m_path, error);
+	}
+
+	// no connections are accepted any more, so the readers can be joined without the lock
+	for (auto const& reader : m_readers) {
+		if (const auto connection = reader.connection.lock()) {
+			connection->shutdown();
+		}
+	}
+	m_readers.clear();
+
+	for (auto& worker : m_workers) {
+		worker.request_stop();
+	}
+	m_workers.clear();
+	m_queue_depth_metric.add(-i64(m_queue.size()));
+	m_queue.clear();
+}
+
+auto classification_daemon::accept_loop(std::stop_token stop) -> void {
+	while (!stop.stop_requested()) {
+		const auto fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			if (!stop.stop_requested()) {
+				spdlog::error("Failed to accept a connection: {}", strerror(errno));
+			}
+			return;
+		}
+		const auto connection = std::make_shared<__internal::daemon_connection>(fd);
+		const auto lock = std::scoped_lock(m_readers_mutex);
+		// finished readers are about to return, so joining them here does not block
+		std::erase_if(m_readers, [](__internal::daemon_reader const& reader) {
+			return reader.done->load(std::memory_order_acquire);
+		});
+		auto done = std::make_unique<std::atomic<bool>>(false);
+		auto thread = std::jthread([this, connection, &done = *done]() {
+			read_loop(connection);
+			done.store(true, std::memory_order_release);
+		});
+		m_readers.push_back(__internal::daemon_reader{
+			.connection = connection,
+			.done = std::move(done),
+			.thread = std::move(thread),
+		});
+	}
+}
+
+auto classification_daemon::read_loop(std::shared_ptr<__internal::daemon_connection> connection)
+	-> void {
+	auto header = std::array<u32, 3>{};
+	while (connection->read(header.data(), __internal::DAEMON_REQUEST_HEADER_SIZE)) {
+		const auto [id, arity, n_tuples] = header;
+		const auto size = u64(arity) * n_tuples;
+		if (size > m_options.max_request_size) {
+			// the rest of the stream cannot be trusted to start at a request
+			spdlog::error("Rejected a request of {} bytes", size);
+			connection->answer(id, DAEMON_REJECTED);
+			return;
+		}
+		auto key = std::string(sizeof(arity) + size, '\0');
+		std::memcpy(key.data(), &arity, sizeof(arity));
+		if (!connection->read(key.data() + sizeof(arity), size)) {
+			return;
+		}
+		const auto received = std::chrono::steady_clock::now();
+		m_n_requests.fetch_add(1, std::memory_order_relaxed);
+		m_requests_metric.add();
+		if (arity == 0) {
+			connection->answer(id, DAEMON_REJECTED);
+			continue;
+		}
+		if (const auto cached = find_cached(key)) {
+			m_n_cache_hits.fetch_add(1, std::memory_order_relaxed);
+			m_cache_hits_metric.add();
+			connection->answer(id, u8(cached.value()));
+			m_latency_metric.record(std::chrono::steady_clock::now() - received);
+			continue;
+		}
+
+		auto _relation = relation(arity);
+		_relation.reserve(n_tuples);
+		for (auto i = size_t(0); i < n_tuples; ++i) {
+			auto entry = relation_entry(arity);
+			for (auto j = size_t(0); j < arity; ++j) {
+				entry[j] = u8(key[sizeof(arity) + i * arity + j]);
+			}
+			_relation.insert(std::move(entry));
+		}
+		{
+			const auto lock = std::scoped_lock(m_queue_mutex);
+			m_queue.push_back(__internal::daemon_job{
+				.connection = connection,
+				.id = id,
+				._relation = std::move(_relation),
+				.key = std::move(key),
+				.received = received,
+			});
+		}
+		m_queue_depth_metric.add(1);
+		m_queue_ready.notify_one();
+	}
+}
+
+auto classification_daemon::work_loop(std::stop_token stop, polymorphism_checker checker) -> void {
+	while (!stop.stop_requested()) {
+		auto job = [&]() -> std::optional<__internal::daemon_job> {
+			auto lock = std::unique_lock(m_queue_mutex);
+			if (!m_queue_ready.wait(lock, stop, [&] { return !m_queue.empty(); })) {
+				return std::nullopt;
+			}
+			auto front = std::move(m_queue.front());
+			m_queue.pop_front();
+			return front;
+		}();
+		if (!job.has_value()) {
+			return;
+		}
+		m_queue_depth_metric.add(-1);
+		const auto result = checker(job->_relation);
+		insert_cached(std::move(job->key), result);
+		job->connection->answer(job->id, u8(result));
+		m_latency_metric.record(std::chrono::steady_clock::now() - job->received);
+	}
+}
+
+auto classification_daemon::find_cached(std::string const& key) -> std::optional<satisfiability> {
+	const auto lock = std::scoped_lock(m_cache_mutex);
+	const auto it = m_cache_positions.find(key);
+	if (it == m_cache_positions.end()) {
+		return std::nullopt;
+	}
+	m_cache.splice(m_cache.begin(), m_cache, it->second);
+	return it->second->second;
+}
+
+auto classification_daemon::insert_cached(std::string key, satisfiability result) -> void {
+	const auto lock = std::scoped_lock(m_cache_mutex);
+	// another worker may have classified the same relation meanwhile
+	if (m_options.result_cache_capacity == 0 || m_cache_positions.contains(key)) {
+		return;
+	}
+	m_cache.emplace_front(std::move(key), result);
+	// keyed by a view of the string in the list, which stays put as entries move
+	m_cache_positions.emplace(m_cache.front().first, m_cache.begin());
+	if (m_cache.size() > m_options.result_cache_capacity) {
+		m_cache_positions.erase(m_cache.back().first);
+		m_cache.pop_back();
+	}
+}
+
+auto classify_remote(std::filesystem::path const& path, std::vector<relation> const& relations)
+	-> std::optional<std::vector<satisfiability>> {
+	const auto too_large = [](relation const& _relation) {
+		return std::ranges::any_of(_relation, [](relation_entry const& entry) {
+			return std::ranges::any_of(entry, [](domain_value value) { return value > 0xff; });
+		});
+	};
+	if (std::ranges::any_of(relations, too_large)) {
+		spdlog::error("The daemon protocol only carries domain values below 256");
+		return std::nullopt;
+	}
+	const auto connection = gautil::connect_unix_socket(path);
+	if (!connection.has_value()) {
+		return std::nullopt;
+	}
+	const auto fd = connection.value();
+
+	// requests are written while answers are read, so neither side blocks on a full socket
+	auto writer = std::jthread([&]() {
+		auto message = std::vector<char>{};
+		for (auto i = size_t(0); i < relations.size(); ++i) {
+			const auto header = std::array<u32, 3>{
+				u32(i), u32(relations[i].arity()), u32(relations[i].size())};
+			message.resize(__internal::DAEMON_REQUEST_HEADER_SIZE);
+			std::memcpy(message.data(), header.data(), message.size());
+			for (auto const& entry : relations[i]) {
+				std::ranges::transform(entry, std::back_inserter(message), [](domain_value value) {
+					return char(value);
+				});
+			}
+			if (!gautil::send_all(fd, message.data(), message.size())) {
+				break;
+			}
+		}
+		::shutdown(fd, SHUT_WR);
+	});
+
+	auto reader = __internal::socket_reader(fd);
+	auto results = std::vector<satisfiability>(relations.size());
+	auto success = true;
+	for (auto i = size_t(0); i < relations.size(); ++i) {
+		auto answer = std::array<char, __internal::DAEMON_ANSWER_SIZE>{};
+		if (!reader.read(answer.data(), answer.size())) {
+			spdlog::error("{} closed the connection", path.string());
+			success = false;
+			break;
+		}
+		auto id = u32{0};
+		std::memcpy(&id, answer.data(), sizeof(id));
+		const auto result = u8(answer[sizeof(id)]);
+		if (id >= relations.size() || result == DAEMON_REJECTED) {
+			spdlog::error("{} rejected relation {}", path.string(), id);
+			success = false;
+			break;
+		}
+		results[id] = satisfiability(result);
+	}
+	if (!success) {
+		// wakes the writer if the daemon stopped reading
+		::shutdown(fd, SHUT_RDWR);
+	}
+	writer.join();
+	::close(fd);
+	return success ? std::optional{results} : std::nullopt;
+}
+} // namespace cspc
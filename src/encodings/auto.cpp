@@ -0,0 +1,59 @@
+#include "cspc/encodings/auto.hpp"
+
+#include "cspc/encodings/binary.hpp"
+#include "cspc/encodings/direct.hpp"
+#include "cspc/encodings/label_cover.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace cspc {
+auto default_encoding_candidates() -> std::vector<encoding_candidate> const& {
+	// NOTE: weights in ms, fitted by `cspc_profiler_compare_encodings --fit` on its 132 siggers
+	// meta-CSPs (R^2 at least 0.985 for every candidate). The fit ran where kissat could not be
+	// built, with z3's SAT core behind kissat's API in its place, so the weights rank encodings by
+	// that solver's costs; refit them with kissat, and whenever the encodings or the solver change
+	static const auto candidates = std::vector<encoding_candidate>{
+		{"direct", direct_encoding, direct_encoding_statistics, {8.27e-4, 3.39e-3, 0.0, 4.01}},
+		{"multivalued direct",
+		 multivalued_direct_encoding,
+		 multivalued_direct_encoding_statistics,
+		 {3.01e-3, 3.04e-3, 5.89e-5, 3.23}},
+		{"binary", binary_encoding, binary_encoding_statistics, {1.04e-2, 0.0, 1.51e-3, 3.8}},
+		{"log", log_encoding, log_encoding_statistics, {1.06e-2, 7.79e-4, 1.38e-3, 3.86}},
+		{"label cover",
+		 label_cover_encoding,
+		 label_cover_encoding_statistics,
+		 {0.0, 0.0, 1.71e-3, 0.0}},
+		{"multivalued label cover",
+		 multivalued_label_cover_encoding,
+		 multivalued_label_cover_encoding_statistics,
+		 {1.28e-2, 0.0, 0.0, 0.0}},
+	};
+	return candidates;
+}
+
+auto predicted_cost(encoding_statistics const& statistics, encoding_cost_model const& model)
+	-> f64 {
+	return model.per_variable * statistics.n_variables + model.per_clause * statistics.n_clauses +
+		   model.per_literal * statistics.n_literals +
+		   model.per_relation_density * statistics.relation_density;
+}
+
+auto select_encoding(csp const& csp, std::vector<encoding_candidate> const& candidates)
+	-> encoding_candidate const& {
+	assert(!candidates.empty());
+	return *std::ranges::min_element(candidates, {}, [&](encoding_candidate const& candidate) {
+		return predicted_cost(candidate.statistics(csp), candidate.cost_model);
+	});
+}
+
+auto create_auto_encoding(std::vector<encoding_candidate> candidates) -> encoding {
+	return [candidates = std::move(candidates)](csp const& csp) {
+		return select_encoding(csp, candidates).encode(csp);
+	};
+}
+
+auto auto_encoding(csp const& csp) -> sat {
+	return select_encoding(csp, default_encoding_candidates()).encode(csp);
+}
+} // namespace cspc
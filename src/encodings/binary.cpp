@@ -4,98 +4,458 @@
 #include "cspc/encodings/common.hpp"
 #include <cmath>
 #include <gautil/functional.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <ranges>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace cspc {
 
 namespace __internal {
-template <std::output_iterator<clause> OutputIterator>
-auto create_nogood_clauses(
-	std::vector<constraint> const nogoods, size_t n_bits, OutputIterator result) -> OutputIterator {
-	std::ranges::for_each(nogoods, [&](constraint const& nogood) {
-		const auto arity = nogood.get_relation().arity();
-		result = std::ranges::transform(nogood.get_relation(), result, [&](auto const& entry) {
-					 auto _clause = clause{};
-					 _clause.reserve(n_bits * arity);
-					 for (auto j = 0u; j < arity; ++j) {
-						 auto v = entry[j];
-						 for (auto k = 0u; k < n_bits; ++k) {
-							 const auto bit = v & 1;
-							 _clause.push_back(literal(
-								 nogood.variables()[j] * n_bits + k, bit ? NEGATED : REGULAR));
-							 v >>= 1;
-						 }
-					 }
-					 return _clause;
-				 }).out;
+auto n_bits(size_t domain_size) -> size_t {
+	return std::numeric_limits<size_t>::digits - std::countl_zero(domain_size);
+}
+
+namespace {
+auto full_mask(size_t width) -> u32 { return u32((u64(1) << width) - 1); }
+
+// calls fn on every minterm of the cube
+template <typename Fn> auto for_each_minterm(cube _cube, size_t width, Fn fn) -> void {
+	const auto free = ~_cube.mask & full_mask(width);
+	auto subset = u32(0);
+	do {
+		fn(_cube.value | subset);
+		subset = (subset - free) & free;
+	} while (subset != 0);
+}
+
+auto covers_off_minterm(
+	std::vector<minterm_status> const& truth_table, cube _cube, size_t width) -> bool {
+	auto found = false;
+	for_each_minterm(_cube, width, [&](u32 minterm) {
+		found = found || truth_table[minterm] == MINTERM_OFF;
 	});
-	return result;
+	return found;
 }
 
-auto create_prohibited_value_clause(variable v, domain_value d, size_t n_bits) -> clause {
-	auto _clause = clause{};
-	_clause.reserve(n_bits);
-	for (auto k = 0u; k < n_bits; ++k) {
-		auto bit = d & 1;
-		_clause.push_back(literal(v * n_bits + k, bit ? NEGATED : REGULAR));
-		d >>= 1;
+auto quine_mccluskey_primes(std::vector<minterm_status> const& truth_table, size_t width)
+	-> std::vector<cube> {
+	const auto key = [](cube _cube) { return u64(_cube.mask) << 32 | _cube.value; };
+	auto implicants = std::vector<cube>{};
+	for (auto minterm = u32(0); minterm < truth_table.size(); ++minterm) {
+		if (truth_table[minterm] != MINTERM_OFF) {
+			implicants.push_back({full_mask(width), minterm});
+		}
 	}
-	return _clause;
+	auto primes = std::vector<cube>{};
+	while (!implicants.empty()) {
+		auto index = std::unordered_map<u64, size_t>{};
+		for (auto i = size_t(0); i < implicants.size(); ++i) {
+			index.emplace(key(implicants[i]), i);
+		}
+		auto merged = std::vector<bool>(implicants.size(), false);
+		auto next = std::vector<cube>{};
+		auto seen = std::unordered_set<u64>{};
+		for (auto i = size_t(0); i < implicants.size(); ++i) {
+			auto const& implicant = implicants[i];
+			for (auto bit = size_t(0); bit < width; ++bit) {
+				const auto b = u32(1) << bit;
+				if ((implicant.mask & b) == 0 || (implicant.value & b) != 0) {
+					continue;
+				}
+				const auto partner = index.find(key({implicant.mask, implicant.value | b}));
+				if (partner == index.end()) {
+					continue;
+				}
+				merged[i] = true;
+				merged[partner->second] = true;
+				const auto combined = cube{implicant.mask & ~b, implicant.value};
+				if (seen.insert(key(combined)).second) {
+					next.push_back(combined);
+				}
+			}
+		}
+		for (auto i = size_t(0); i < implicants.size(); ++i) {
+			if (!merged[i]) {
+				primes.push_back(implicants[i]);
+			}
+		}
+		implicants = std::move(next);
+	}
+	return primes;
 }
 
-template <std::output_iterator<clause> OutputIterator>
-auto create_prohibited_value_clauses(
-	size_t n_variables,
-	size_t domain_size,
-	size_t inclusive_domain_size,
-	size_t n_bits,
-	OutputIterator result) -> OutputIterator {
-	for (auto v = 0u; v < n_variables; ++v) {
-		for (auto d = domain_size; d < inclusive_domain_size; ++d) {
-			*result++ = __internal::create_prohibited_value_clause(v, d, n_bits);
+// every ON minterm not yet covered grows into a cube by freeing its bits in turn, as long as the
+// cube stays clear of the OFF minterms
+auto expanded_implicants(std::vector<minterm_status> const& truth_table, size_t width)
+	-> std::vector<cube> {
+	auto covered = std::vector<bool>(truth_table.size(), false);
+	auto implicants = std::vector<cube>{};
+	for (auto minterm = u32(0); minterm < truth_table.size(); ++minterm) {
+		if (truth_table[minterm] != MINTERM_ON || covered[minterm]) {
+			continue;
+		}
+		auto implicant = cube{full_mask(width), minterm};
+		for (auto bit = size_t(0); bit < width; ++bit) {
+			const auto b = u32(1) << bit;
+			if (!covers_off_minterm(truth_table, {implicant.mask, implicant.value ^ b}, width)) {
+				implicant = {implicant.mask & ~b, implicant.value & ~b};
+			}
 		}
+		for_each_minterm(implicant, width, [&](u32 m) { covered[m] = true; });
+		implicants.push_back(implicant);
 	}
-	return result;
+	return implicants;
 }
-} // namespace __internal
 
-auto binary_encoding(csp const& csp) -> sat {
-	const auto n_bits =
-		u64(std::numeric_limits<size_t>::digits - std::countl_zero(csp.domain_size()));
-	const auto inclusive_domain_size = std::pow(2, n_bits);
-	const auto nogoods = __internal::nogoods(csp.constraints(), inclusive_domain_size);
+// the essential implicants, then greedily those covering the most uncovered ON minterms, then
+// without those whose ON minterms all turned out covered by the others
+auto select_cover(
+	std::vector<minterm_status> const& truth_table,
+	size_t width,
+	std::vector<cube> const& implicants) -> std::vector<cube> {
+	auto on_minterms = std::vector<std::vector<u32>>(implicants.size());
+	auto n_covering = std::vector<u32>(truth_table.size(), 0);
+	for (auto i = size_t(0); i < implicants.size(); ++i) {
+		for_each_minterm(implicants[i], width, [&](u32 m) {
+			if (truth_table[m] == MINTERM_ON) {
+				on_minterms[i].push_back(m);
+				++n_covering[m];
+			}
+		});
+	}
 
-	const auto n_clauses = gautil::fold(nogoods, 0ul, std::plus{}, &constraint::relation_size);
-	auto clauses = std::vector<clause>{};
-	clauses.reserve(n_clauses);
+	auto chosen = std::vector<bool>(implicants.size(), false);
+	auto covered = std::vector<bool>(truth_table.size(), false);
+	const auto choose = [&](size_t i) {
+		chosen[i] = true;
+		for (const auto m : on_minterms[i]) {
+			covered[m] = true;
+		}
+	};
+	for (auto i = size_t(0); i < implicants.size(); ++i) {
+		const auto essential = std::ranges::any_of(on_minterms[i], [&](u32 m) {
+			return n_covering[m] == 1;
+		});
+		if (essential) {
+			choose(i);
+		}
+	}
+	while (true) {
+		auto best = implicants.size();
+		auto best_gain = size_t(0);
+		for (auto i = size_t(0); i < implicants.size(); ++i) {
+			if (chosen[i]) {
+				continue;
+			}
+			const auto gain =
+				size_t(std::ranges::count_if(on_minterms[i], [&](u32 m) { return !covered[m]; }));
+			// fewer literals break ties, as a larger cube leaves more room for the rest
+			if (gain > best_gain ||
+				(gain == best_gain && gain > 0 &&
+				 std::popcount(implicants[i].mask) < std::popcount(implicants[best].mask))) {
+				best = i;
+				best_gain = gain;
+			}
+		}
+		if (best_gain == 0) {
+			break;
+		}
+		choose(best);
+	}
+
+	auto n_chosen_covering = std::vector<u32>(truth_table.size(), 0);
+	for (auto i = size_t(0); i < implicants.size(); ++i) {
+		if (chosen[i]) {
+			for (const auto m : on_minterms[i]) {
+				++n_chosen_covering[m];
+			}
+		}
+	}
+	// the smallest cubes are the likeliest to be redundant, so they are tried first
+	auto order = std::vector<size_t>{};
+	for (auto i = size_t(0); i < implicants.size(); ++i) {
+		if (chosen[i]) {
+			order.push_back(i);
+		}
+	}
+	std::ranges::stable_sort(order, std::greater{}, [&](size_t i) {
+		return std::popcount(implicants[i].mask);
+	});
+	auto cover = std::vector<cube>{};
+	for (const auto i : order) {
+		const auto redundant = std::ranges::all_of(on_minterms[i], [&](u32 m) {
+			return n_chosen_covering[m] > 1;
+		});
+		if (redundant) {
+			for (const auto m : on_minterms[i]) {
+				--n_chosen_covering[m];
+			}
+			chosen[i] = false;
+		}
+	}
+	for (auto i = size_t(0); i < implicants.size(); ++i) {
+		if (chosen[i]) {
+			cover.push_back(implicants[i]);
+		}
+	}
+	return cover;
+}
+} // namespace
 
-	__internal::create_nogood_clauses(nogoods, n_bits, std::back_inserter(clauses));
+auto minimize_cover(std::vector<minterm_status> const& truth_table, size_t width)
+	-> std::vector<cube> {
+	assert(truth_table.size() == size_t(1) << width);
+	const auto implicants = width <= MAX_QUINE_MCCLUSKEY_WIDTH
+								? quine_mccluskey_primes(truth_table, width)
+								: expanded_implicants(truth_table, width);
+	return select_cover(truth_table, width, implicants);
+}
 
-	assert(n_clauses == clauses.size());
+auto nogood_cubes(
+	relation const& _relation, size_t domain_size, size_t n_bits, bool out_of_domain_free)
+	-> std::vector<cube> {
+	const auto arity = _relation.arity();
+	const auto width = arity * n_bits;
+	const auto encode = [&](relation_entry const& entry) {
+		auto minterm = u32(0);
+		for (auto j = size_t(0); j < arity; ++j) {
+			minterm |= u32(entry[j]) << (j * n_bits);
+		}
+		return minterm;
+	};
 
-	return sat(std::move(clauses));
+	assert(width <= MAX_MINIMIZED_WIDTH);
+
+	const auto value_mask = full_mask(n_bits);
+	const auto out_of_domain = out_of_domain_free ? MINTERM_DC : MINTERM_ON;
+	auto truth_table = std::vector<minterm_status>(size_t(1) << width, MINTERM_ON);
+	for (auto minterm = u32(0); minterm < truth_table.size(); ++minterm) {
+		for (auto j = size_t(0); j < arity; ++j) {
+			if (((minterm >> (j * n_bits)) & value_mask) >= domain_size) {
+				truth_table[minterm] = out_of_domain;
+				break;
+			}
+		}
+	}
+	for (auto const& entry : _relation) {
+		truth_table[encode(entry)] = MINTERM_OFF;
+	}
+	return minimize_cover(truth_table, width);
 }
 
-auto log_encoding(csp const& csp) -> sat {
-	const auto n_bits =
-		u64(std::numeric_limits<size_t>::digits - std::countl_zero(csp.domain_size()));
-	const auto nogoods = __internal::nogoods(csp.constraints(), csp.domain_size());
-	const auto inclusive_domain_size = std::pow(2, n_bits);
+auto prohibited_value_cubes(size_t domain_size, size_t n_bits) -> std::vector<cube> {
+	auto truth_table = std::vector<minterm_status>(size_t(1) << n_bits, MINTERM_ON);
+	std::fill_n(truth_table.begin(), std::min(domain_size, truth_table.size()), MINTERM_OFF);
+	return minimize_cover(truth_table, n_bits);
+}
+
+namespace {
+// the most recently used minimized relations are kept, so that a sweep minimizes each relation
+// once
+constexpr auto NOGOOD_CUBE_STORE_CAPACITY = size_t{1} << 16;
 
-	const auto n_clauses = gautil::fold(nogoods, 0ul, std::plus{}, &constraint::relation_size) +
-						   n_bits * csp.n_variables() * (inclusive_domain_size - csp.domain_size());
+// the nogood cubes of a relation, or its nogoods as they are when it is too wide to be minimized
+struct nogood_cover {
+	std::vector<cube> cubes;
+	relation nogoods;
+};
+
+auto create_nogood_cover(
+	relation const& _relation, size_t domain_size, size_t n_bits, bool out_of_domain_free)
+	-> nogood_cover {
+	if (_relation.arity() * n_bits <= MAX_MINIMIZED_WIDTH) {
+		return {nogood_cubes(_relation, domain_size, n_bits, out_of_domain_free), relation{}};
+	}
+	auto scope = std::vector<variable>(_relation.arity());
+	std::iota(scope.begin(), scope.end(), variable(0));
+	const auto nogood_domain_size = out_of_domain_free ? domain_size : size_t(1) << n_bits;
+	return {{}, inverse(constraint(_relation, scope), nogood_domain_size).get_relation()};
+}
+
+struct nogood_cube_key {
+	relation _relation;
+	size_t domain_size;
+	bool out_of_domain_free;
+	auto operator==(nogood_cube_key const& other) const -> bool = default;
+};
+
+struct nogood_cube_key_hash {
+	auto operator()(nogood_cube_key const& key) const -> size_t {
+		return mix_hash(
+			std::hash<relation>{}(key._relation) + key.domain_size * 2 + key.out_of_domain_free);
+	}
+};
+
+// the nogood covers of the most recently used relations, shared by all binary and log encodings
+// and their statistics, most recently used first
+class nogood_cube_store {
+  public:
+	using cover_ptr = std::shared_ptr<nogood_cover const>;
+
+	auto find(relation const& _relation, size_t domain_size, size_t n_bits, bool out_of_domain_free)
+		-> cover_ptr {
+		auto key = nogood_cube_key{_relation, domain_size, out_of_domain_free};
+		{
+			const auto lock = std::scoped_lock(m_mutex);
+			if (const auto it = m_positions.find(key); it != m_positions.end()) {
+				m_covers.splice(m_covers.begin(), m_covers, it->second);
+				return it->second->second;
+			}
+		}
+		// minimized outside the lock, as other relations need not wait for it
+		const auto cover = std::make_shared<nogood_cover const>(
+			create_nogood_cover(_relation, domain_size, n_bits, out_of_domain_free));
+		const auto lock = std::scoped_lock(m_mutex);
+		// another thread may have minimized the same relation meanwhile
+		if (m_positions.contains(key)) {
+			return cover;
+		}
+		m_covers.emplace_front(key, cover);
+		m_positions.emplace(std::move(key), m_covers.begin());
+		if (m_covers.size() > NOGOOD_CUBE_STORE_CAPACITY) {
+			m_positions.erase(m_covers.back().first);
+			m_covers.pop_back();
+		}
+		return cover;
+	}
+
+  private:
+	using entry = std::pair<nogood_cube_key, cover_ptr>;
+
+	std::mutex m_mutex;
+	std::list<entry> m_covers;
+	std::unordered_map<nogood_cube_key, std::list<entry>::iterator, nogood_cube_key_hash>
+		m_positions;
+};
+
+auto global_nogood_cube_store() -> nogood_cube_store& {
+	static auto store = nogood_cube_store{};
+	return store;
+}
+} // namespace
+
+// the nogood cover of each distinct relation of a csp, looked up in the store once per relation
+class nogood_cube_cache {
+  public:
+	nogood_cube_cache(size_t domain_size, size_t n_bits, bool out_of_domain_free)
+		: m_domain_size{domain_size}, m_n_bits{n_bits}, m_out_of_domain_free{out_of_domain_free} {}
+
+	auto find(relation const& _relation) -> nogood_cover const& {
+		auto it = m_covers.find(_relation);
+		if (it == m_covers.end()) {
+			const auto cover = global_nogood_cube_store().find(
+				_relation, m_domain_size, m_n_bits, m_out_of_domain_free);
+			it = m_covers.emplace(_relation, cover).first;
+		}
+		return *it->second;
+	}
+
+  private:
+	size_t m_domain_size;
+	size_t m_n_bits;
+	bool m_out_of_domain_free;
+	std::unordered_map<relation, std::shared_ptr<nogood_cover const>> m_covers;
+};
+
+auto n_cube_literals(std::span<cube const> cubes) -> size_t {
+	return gautil::fold(cubes, size_t(0), std::plus{}, [](cube const& _cube) {
+		return size_t(std::popcount(_cube.mask));
+	});
+}
+
+// the nogood cubes of every constraint, followed by the prohibited value cubes of every variable
+auto cube_statistics(
+	csp const& csp, size_t n_bits, nogood_cube_cache& cache, std::span<cube const> prohibited)
+	-> encoding_statistics {
+	auto n_cube_clauses = csp.n_variables() * prohibited.size();
+	auto n_literals = csp.n_variables() * n_cube_literals(prohibited);
+	for (auto const& constraint : csp.constraints()) {
+		auto const& cover = cache.find(constraint.get_relation());
+		n_cube_clauses += cover.cubes.size() + cover.nogoods.size();
+		n_literals += n_cube_literals(cover.cubes) +
+					  cover.nogoods.size() * constraint.variables().size() * n_bits;
+	}
+	return encoding_statistics{
+		.n_variables = csp.n_variables() * n_bits,
+		.n_clauses = n_cube_clauses,
+		.n_literals = n_literals,
+		.relation_density = __internal::mean_relation_density(csp),
+	};
+}
+
+auto cube_encoding(csp const& csp, bool log, encoding_metrics const& metrics) -> sat {
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto n_bits = __internal::n_bits(csp.domain_size());
+	// values outside the domain are left to the prohibited value clauses of the log encoding
+	auto cache = nogood_cube_cache(csp.domain_size(), n_bits, log);
+	const auto prohibited =
+		log ? prohibited_value_cubes(csp.domain_size(), n_bits) : std::vector<cube>{};
+	const auto n_clauses = cube_statistics(csp, n_bits, cache, prohibited).n_clauses;
 	auto clauses = std::vector<clause>{};
 	clauses.reserve(n_clauses);
 
-	__internal::create_nogood_clauses(nogoods, n_bits, std::back_inserter(clauses));
-	__internal::create_prohibited_value_clauses(
-		csp.n_variables(), csp.domain_size(), inclusive_domain_size, n_bits,
-		std::back_inserter(clauses));
+	for (auto const& constraint : csp.constraints()) {
+		auto const& cover = cache.find(constraint.get_relation());
+		create_cube_clauses(
+			cover.cubes, constraint.variables(), n_bits, std::back_inserter(clauses));
+		create_nogood_clauses(
+			cover.nogoods, constraint.variables(), n_bits, std::back_inserter(clauses));
+	}
+	if (log) {
+		for (auto v = variable(0); v < csp.n_variables(); ++v) {
+			create_cube_clauses(prohibited, {v}, n_bits, std::back_inserter(clauses));
+		}
+	}
 
 	assert(n_clauses == clauses.size());
 
+	metrics.clauses.record(clauses.size());
 	return sat(std::move(clauses));
 }
+} // namespace __internal
+
+auto binary_encoding_statistics(csp const& csp) -> encoding_statistics {
+	const auto n_bits = __internal::n_bits(csp.domain_size());
+	auto cache = __internal::nogood_cube_cache(csp.domain_size(), n_bits, false);
+	return __internal::cube_statistics(csp, n_bits, cache, {});
+}
+
+auto log_encoding_statistics(csp const& csp) -> encoding_statistics {
+	// values outside the domain are left to the prohibited value clauses
+	const auto n_bits = __internal::n_bits(csp.domain_size());
+	auto cache = __internal::nogood_cube_cache(csp.domain_size(), n_bits, true);
+	return __internal::cube_statistics(
+		csp, n_bits, cache, __internal::prohibited_value_cubes(csp.domain_size(), n_bits));
+}
+
+auto decode_binary_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value> {
+	const auto n_bits = __internal::n_bits(csp.domain_size());
+	auto values = std::vector<domain_value>(csp.n_variables());
+	for (auto var = variable(0); var < csp.n_variables(); ++var) {
+		for (auto k = 0u; k < n_bits; ++k) {
+			const auto bit = var * n_bits + k;
+			if (bit < _assignment.size() && _assignment[bit]) {
+				values[var] |= domain_value(1) << k;
+			}
+		}
+	}
+	return values;
+}
+
+auto binary_encoding(csp const& csp) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("binary");
+	return __internal::cube_encoding(csp, false, metrics);
+}
+
+auto log_encoding(csp const& csp) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("log");
+	return __internal::cube_encoding(csp, true, metrics);
+}
 
 } // namespace cspc
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "cspc/encodings/common.hpp"
 
+#include <cmath>
+#include <gautil/functional.hpp>
+#include <thread>
+
 namespace cspc {
 namespace __internal {
 auto nogoods(std::vector<constraint> const& constraints, size_t domain_size)
@@ -11,6 +15,123 @@ auto nogoods(std::vector<constraint> const& constraints, size_t domain_size)
 		[&](constraint const& constraint) { return inverse(constraint, domain_size); });
 	return nogoods;
 }
+
+auto combine_encoded(sat const& shared, sat const& part, variable first_auxiliary_variable)
+	-> sat {
+	// literal::variable() is one-indexed
+	const auto shared_max_variable = gautil::fold(
+		shared.clauses(), u64(first_auxiliary_variable), [](u64 lhs, u64 rhs) {
+			return std::max(lhs, rhs);
+		},
+		[](clause const& _clause) {
+			return gautil::fold(_clause, u64(0), [](u64 lhs, u64 rhs) { return std::max(lhs, rhs); },
+								&literal::variable);
+		});
+
+	auto clauses = std::vector<clause>{};
+	clauses.reserve(shared.clauses().size() + part.clauses().size());
+	std::ranges::copy(shared.clauses(), std::back_inserter(clauses));
+	auto max_variable = shared_max_variable;
+	append_encoded(clauses, max_variable, part, first_auxiliary_variable);
+	return sat(std::move(clauses));
+}
+
+auto append_encoded(
+	std::vector<clause>& clauses,
+	u64& max_variable,
+	sat const& part,
+	variable first_auxiliary_variable,
+	std::span<clause const> skipped) -> void {
+	const auto offset = max_variable - first_auxiliary_variable;
+	auto part_max_variable = max_variable;
+	for (auto _clause : part.clauses()) {
+		if (std::ranges::binary_search(skipped, _clause, clause_less{})) {
+			continue;
+		}
+		for (auto& lit : _clause) {
+			if (lit.variable() > first_auxiliary_variable) {
+				lit.value += lit.value < 0 ? -i64(offset) : i64(offset);
+			}
+			part_max_variable = std::max(part_max_variable, u64(lit.variable()));
+		}
+		clauses.push_back(std::move(_clause));
+	}
+	max_variable = part_max_variable;
+}
+
+auto decode_one_hot(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value> {
+	const auto domain_size = csp.domain_size();
+	auto values = std::vector<domain_value>(csp.n_variables());
+	for (auto var = variable(0); var < csp.n_variables(); ++var) {
+		for (auto k = domain_value(0); k < domain_size; ++k) {
+			const auto xj_eq_k = var * domain_size + k;
+			if (xj_eq_k < _assignment.size() && _assignment[xj_eq_k]) {
+				values[var] = k;
+				break;
+			}
+		}
+	}
+	return values;
+}
+
+auto n_nogoods(constraint const& _constraint, size_t domain_size) -> size_t {
+	return (size_t)std::pow(domain_size, _constraint.arity()) - _constraint.relation_size();
+}
+
+auto mean_relation_density(csp const& csp) -> f64 {
+	if (csp.constraints().empty()) {
+		return 0.0;
+	}
+	const auto total_density =
+		gautil::fold(csp.constraints(), f64(0), std::plus{}, [&](constraint const& constraint) {
+			return f64(constraint.relation_size()) /
+				   std::pow(csp.domain_size(), constraint.arity());
+		});
+	return total_density / csp.constraints().size();
+}
+
+auto create_encoding_metrics(std::string const& encoding_name) -> encoding_metrics {
+	const auto labels = metric_labels{{"encoding", encoding_name}};
+	return encoding_metrics{
+		.seconds = global_metrics().histogram(
+			"cspc_encoding_seconds", "Time taken to encode a csp as sat", METRIC_SECONDS, labels),
+		.clauses = global_metrics().histogram(
+			"cspc_encoding_clauses", "Clauses of an encoded csp", 1.0, labels),
+	};
+}
+
+auto fill_clauses_in_parallel(
+	std::vector<clause>& clauses,
+	std::span<size_t const> counts,
+	size_t n_threads,
+	clause_range_filler const& fill) -> void {
+	// offsets[i] is the first clause of constraint i
+	auto offsets = std::vector<size_t>(counts.size() + 1, 0);
+	std::inclusive_scan(counts.begin(), counts.end(), offsets.begin() + 1);
+	const auto first = clauses.size();
+	clauses.resize(first + offsets.back());
+
+	n_threads = std::max(n_threads, size_t(1));
+	auto bounds = std::vector<size_t>{0};
+	for (auto t = size_t(1); t < n_threads; ++t) {
+		const auto target = offsets.back() * t / n_threads;
+		bounds.push_back(size_t(std::ranges::lower_bound(offsets, target) - offsets.begin()));
+	}
+	bounds.push_back(counts.size());
+
+	const auto fill_range = [&](size_t t) {
+		if (bounds[t] < bounds[t + 1]) {
+			fill(bounds[t], bounds[t + 1], clauses.begin() + i64(first + offsets[bounds[t]]));
+		}
+	};
+	auto threads = std::vector<std::jthread>{};
+	threads.reserve(n_threads - 1);
+	for (auto t = size_t(1); t < n_threads; ++t) {
+		threads.emplace_back(fill_range, t);
+	}
+	fill_range(0);
+}
 } // namespace __internal
 auto create_encoding_solver(operation const& _operation, encoding _encoding, solver _solver)
 	-> polymorphism_checker {
@@ -20,4 +141,43 @@ auto create_encoding_solver(operation const& _operation, encoding _encoding, sol
 		return _solver(sat);
 	};
 }
+
+auto create_multi_encoding_solver(
+	std::vector<operation> const& operations, encoding _encoding, solver _solver)
+	-> multi_polymorphism_checker {
+	return [operations, _encoding, _solver](cspc::relation const& relation) {
+		const auto domain_size = __internal::find_relation_domain_size(relation);
+		auto result = std::vector<satisfiability>(operations.size());
+
+		auto arities = std::vector<size_t>{};
+		std::ranges::transform(operations, std::back_inserter(arities), &operation::arity);
+		std::ranges::sort(arities);
+		const auto [first, last] = std::ranges::unique(arities);
+		arities.erase(first, last);
+
+		for (auto const arity : arities) {
+			const auto polymorphism_constraints =
+				__internal::construct_is_polymorphism_constraints(relation, domain_size, arity);
+
+			// the function table followed by one variable per domain value for identities with
+			// variables; anything past them is auxiliary to a particular encoding
+			const auto n_variables = (size_t)std::pow(domain_size, arity) + domain_size;
+			const auto first_auxiliary_variable = variable(n_variables * domain_size);
+			const auto shared =
+				_encoding(csp(polymorphism_constraints, n_variables, domain_size));
+
+			for (auto i = size_t(0); i < operations.size(); ++i) {
+				if (operations[i].arity != arity) {
+					continue;
+				}
+				const auto identity_constraints =
+					__internal::construct_operation_identity_constraints(operations[i], domain_size);
+				const auto part = _encoding(csp(identity_constraints, n_variables, domain_size));
+				result[i] = _solver(
+					__internal::combine_encoded(shared, part, first_auxiliary_variable));
+			}
+		}
+		return result;
+	};
+}
 } // namespace cspc
@@ -8,35 +8,49 @@
 
 namespace cspc {
 
-namespace __internal {
-template <std::output_iterator<clause> outputiterator>
-auto conflict_clauses(
-	std::vector<constraint> const& nogoods, size_t domain_size, outputiterator result)
-	-> outputiterator {
-	std::ranges::for_each(nogoods, [&](constraint const& nogood) {
-		const auto arity = nogood.get_relation().arity();
-		result = std::ranges::transform(nogood.get_relation(), result, [&](auto const& entry) {
-					 auto _clause = clause{};
-					 _clause.reserve(arity);
-					 for (auto k = 0u; k < arity; ++k) {
-						 const auto xk_eq_nogoodjk = nogood.variables()[k] * domain_size + entry[k];
-						 _clause.push_back(literal(xk_eq_nogoodjk, NEGATED));
-					 }
-					 return _clause;
-				 }).out;
-	});
-	return result;
+auto direct_encoding_statistics(csp const& csp) -> encoding_statistics {
+	const auto domain_size = csp.domain_size();
+	const auto n_conflict_clauses = gautil::fold(
+		csp.constraints(), 0ul, std::plus{},
+		[&](auto const& constraint) { return __internal::n_nogoods(constraint, domain_size); });
+	const auto n_conflict_literals =
+		gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
+			return __internal::n_nogoods(constraint, domain_size) * constraint.arity();
+		});
+	const auto n_at_most_one_clauses = csp.n_variables() * gautil::n_choose_k(domain_size, 2);
+	return encoding_statistics{
+		.n_variables = csp.n_variables() * domain_size,
+		.n_clauses = n_at_most_one_clauses + csp.n_variables() + n_conflict_clauses,
+		.n_literals =
+			2 * n_at_most_one_clauses + csp.n_variables() * domain_size + n_conflict_literals,
+		.relation_density = __internal::mean_relation_density(csp),
+	};
+}
+
+auto multivalued_direct_encoding_statistics(csp const& csp) -> encoding_statistics {
+	// the direct encoding without the at most one clauses
+	auto statistics = direct_encoding_statistics(csp);
+	const auto n_at_most_one_clauses =
+		csp.n_variables() * gautil::n_choose_k(csp.domain_size(), 2);
+	statistics.n_clauses -= n_at_most_one_clauses;
+	statistics.n_literals -= 2 * n_at_most_one_clauses;
+	return statistics;
+}
+
+auto decode_direct_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value> {
+	// in the multivalued encoding any one of the values assigned to a variable will do
+	return __internal::decode_one_hot(csp, _assignment);
 }
-} // namespace __internal
 
 auto direct_encoding(csp const& csp) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("direct");
+	const auto timer = scoped_timer(metrics.seconds);
+
 	const auto domain_size = csp.domain_size();
 	const auto nogoods = __internal::nogoods(csp.constraints(), csp.domain_size());
 
-	auto n_clauses =
-		csp.n_variables() * gautil::n_choose_k(domain_size, 2) +			   // at most one
-		gautil::fold(csp.constraints(), 0u, std::plus{}, &constraint::arity) + // at least one
-		gautil::fold(nogoods, 0u, std::plus{}, &constraint::relation_size);	   // conflict
+	const auto n_clauses = direct_encoding_statistics(csp).n_clauses;
 
 	auto clauses = std::vector<clause>{};
 	clauses.reserve(n_clauses);
@@ -47,16 +61,18 @@ auto direct_encoding(csp const& csp) -> sat {
 
 	assert(n_clauses == clauses.size());
 
+	metrics.clauses.record(clauses.size());
 	return sat(std::move(clauses));
 }
 
 auto multivalued_direct_encoding(csp const& csp) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("multivalued_direct");
+	const auto timer = scoped_timer(metrics.seconds);
+
 	const auto domain_size = csp.domain_size();
 	const auto nogoods = __internal::nogoods(csp.constraints(), csp.domain_size());
 
-	auto n_clauses =
-		gautil::fold(csp.constraints(), 0u, std::plus{}, &constraint::arity) + // at least one
-		gautil::fold(nogoods, 0u, std::plus{}, &constraint::relation_size);	   // conflict
+	const auto n_clauses = multivalued_direct_encoding_statistics(csp).n_clauses;
 
 	auto clauses = std::vector<clause>{};
 	clauses.reserve(n_clauses);
@@ -66,6 +82,61 @@ auto multivalued_direct_encoding(csp const& csp) -> sat {
 
 	assert(n_clauses == clauses.size());
 
+	metrics.clauses.record(clauses.size());
 	return sat(std::move(clauses));
 }
-} // namespace cspc
\ No newline at end of file
+
+namespace __internal {
+auto parallel_direct_encoding(
+	csp const& csp, size_t n_threads, bool multivalued, encoding_metrics const& metrics) -> sat {
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto domain_size = csp.domain_size();
+	const auto n_clauses = multivalued ? multivalued_direct_encoding_statistics(csp).n_clauses
+									   : direct_encoding_statistics(csp).n_clauses;
+
+	auto clauses = std::vector<clause>{};
+	clauses.reserve(n_clauses);
+
+	if (!multivalued) {
+		__internal::at_most_one_clauses(csp, std::back_inserter(clauses));
+	}
+	__internal::at_least_one_clauses(csp, std::back_inserter(clauses));
+
+	auto counts = std::vector<size_t>{};
+	counts.reserve(csp.constraints().size());
+	std::ranges::transform(csp.constraints(), std::back_inserter(counts), [&](auto const& c) {
+		return __internal::n_nogoods(c, domain_size);
+	});
+	// the nogoods are found on the threads too, as finding them costs about as much as encoding
+	__internal::fill_clauses_in_parallel(
+		clauses, counts, n_threads, [&](size_t begin, size_t end, auto out) {
+			for (auto i = begin; i < end; ++i) {
+				const auto nogood = inverse(csp.constraints()[i], domain_size);
+				assert(nogood.relation_size() == counts[i]);
+				out = __internal::conflict_clauses(std::span(&nogood, 1), domain_size, out);
+			}
+		});
+
+	assert(n_clauses == clauses.size());
+
+	metrics.clauses.record(clauses.size());
+	return sat(std::move(clauses));
+}
+} // namespace __internal
+
+auto create_parallel_direct_encoding(size_t n_threads) -> encoding {
+	return [n_threads](csp const& csp) {
+		static const auto metrics = __internal::create_encoding_metrics("parallel_direct");
+		return __internal::parallel_direct_encoding(csp, n_threads, false, metrics);
+	};
+}
+
+auto create_parallel_multivalued_direct_encoding(size_t n_threads) -> encoding {
+	return [n_threads](csp const& csp) {
+		static const auto metrics =
+			__internal::create_encoding_metrics("parallel_multivalued_direct");
+		return __internal::parallel_direct_encoding(csp, n_threads, true, metrics);
+	};
+}
+} // namespace cspc
@@ -3,87 +3,106 @@
 #include "cspc/encodings/common.hpp"
 #include <gautil/functional.hpp>
 #include <gautil/math.hpp>
+#include <numeric>
 
 namespace cspc {
 namespace __internal {
-template <std::output_iterator<clause> outputiterator>
-auto at_most_one_entry_clauses(csp const& csp, outputiterator result) -> outputiterator {
-	auto variable_offset = csp.n_variables() * csp.domain_size();
-	std::ranges::for_each(csp.constraints(), [&](auto const& constraint) {
-		const auto n_entries = constraint.get_relation().size();
-		for (auto j = 0u; j < n_entries; ++j) {
-			const auto entry_variable = variable_offset + j;
-			for (auto k = j + 1; k < n_entries; ++k) {
-				const auto other_entry_variable = variable_offset + k;
-				*result++ = {
-					literal(entry_variable, NEGATED),
-					literal(other_entry_variable, NEGATED),
-				};
-			}
+auto distinct_label_cover_blocks(csp const& csp) -> cspc::csp {
+	const auto& constraints = csp.constraints();
+	const auto same_block_before = [&](size_t i, size_t j) {
+		auto const& a = constraints[i];
+		auto const& b = constraints[j];
+		if (a.variables() != b.variables()) {
+			return a.variables() < b.variables();
 		}
-		variable_offset += n_entries;
-	});
-	return result;
-};
-
-template <std::output_iterator<clause> outputiterator>
-auto at_least_one_entry_clauses(csp const& csp, outputiterator result) -> outputiterator {
-	auto variable_offset = csp.n_variables() * csp.domain_size();
-	return std::ranges::transform(
-			   csp.constraints(), result,
-			   [&](auto const& constraint) {
-				   const auto n_entries = constraint.get_relation().size();
-				   auto _clause = clause{};
-				   _clause.reserve(n_entries);
-				   gautil::repeat(n_entries, [&]() {
-					   _clause.push_back(literal(variable_offset++, REGULAR));
-				   });
-				   return _clause;
-			   })
-		.out;
+		return std::ranges::lexicographical_compare(a.get_relation(), b.get_relation());
+	};
+	const auto same_block = [&](size_t i, size_t j) {
+		return !same_block_before(i, j) && !same_block_before(j, i);
+	};
+
+	// stable, so that the first of each run of equal constraints is its first occurrence
+	auto order = std::vector<size_t>(constraints.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::ranges::stable_sort(order, same_block_before);
+	auto is_first = std::vector<bool>(constraints.size(), false);
+	for (auto i = size_t(0); i < order.size(); ++i) {
+		is_first[order[i]] = i == 0 || !same_block(order[i - 1], order[i]);
+	}
+
+	auto distinct = std::vector<constraint>{};
+	for (auto i = size_t(0); i < constraints.size(); ++i) {
+		if (is_first[i]) {
+			distinct.push_back(constraints[i]);
+		}
+	}
+	return cspc::csp(distinct, csp.n_variables(), csp.domain_size());
 }
 
-template <std::output_iterator<clause> outputiterator>
-auto implication_clauses(csp const& csp, outputiterator result) -> outputiterator {
+auto share_label_cover_blocks(csp const& csp) -> cspc::csp {
+	static auto& shared_blocks = global_metrics().counter(
+		"cspc_label_cover_shared_blocks_total",
+		"Constraints whose label cover entry block was shared with an identical constraint");
+	auto distinct = distinct_label_cover_blocks(csp);
+	shared_blocks.add(csp.constraints().size() - distinct.constraints().size());
+	return distinct;
+}
+
+// the statistics of a csp without repeated constraints
+auto multivalued_label_cover_block_statistics(csp const& csp) -> encoding_statistics {
 	const auto domain_size = csp.domain_size();
-	auto variable_offset = csp.n_variables() * csp.domain_size();
-	std::ranges::for_each(csp.constraints(), [&](auto const& constraint) {
-		// a variable representing an entry in a constraint relation implies an assignment to the
-		// variables which the relation concerns.
-		const auto arity = constraint.get_relation().arity();
-		std::ranges::for_each(constraint.get_relation(), [&](auto const& entry) {
-			const auto relation_entry_true = variable_offset++;
-			for (auto k = 0u; k < arity; ++k) {
-				const auto xk_eq_reljk = constraint.variables()[k] * domain_size + entry[k];
-				*result++ = clause{
-					literal(relation_entry_true, NEGATED),
-					literal(xk_eq_reljk, REGULAR),
-				};
-			}
-		});
+	const auto n_at_most_one_clauses = csp.n_variables() * gautil::n_choose_k(domain_size, 2);
+	const auto n_entries = gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& c) {
+		return c.get_relation().size();
 	});
-	return result;
+	const auto n_implication_clauses =
+		gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
+			return constraint.get_relation().size() * constraint.arity();
+		});
+	return encoding_statistics{
+		.n_variables = csp.n_variables() * domain_size + n_entries,
+		.n_clauses = n_at_most_one_clauses + csp.n_variables() + csp.constraints().size() +
+					 n_implication_clauses,
+		.n_literals = 2 * n_at_most_one_clauses + csp.n_variables() * domain_size + n_entries +
+					  2 * n_implication_clauses,
+		.relation_density = __internal::mean_relation_density(csp),
+	};
 }
-} // namespace __internal
 
-auto label_cover_encoding(csp const& csp) -> sat {
-	// clang-format off
-	auto n_clauses =
-		// at most one var
-		csp.n_variables() * gautil::n_choose_k(csp.domain_size(), 2) +
-		// at least one var
-		gautil::fold(csp.constraints(), 0u, std::plus{}, &constraint::arity) +
-		// at most one entry in relation
+auto label_cover_block_statistics(csp const& csp) -> encoding_statistics {
+	const auto n_at_most_one_entry_clauses =
 		gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
 			return gautil::n_choose_k(constraint.get_relation().size(), 2);
-		}) +
-		// at least one entry in relation
-		csp.constraints().size() +
-		// implication
-		gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
-			return constraint.get_relation().size() * constraint.arity();
 		});
-	// clang-format on
+	auto statistics = multivalued_label_cover_block_statistics(csp);
+	statistics.n_clauses += n_at_most_one_entry_clauses;
+	statistics.n_literals += 2 * n_at_most_one_entry_clauses;
+	return statistics;
+}
+} // namespace __internal
+
+auto label_cover_encoding_statistics(csp const& csp) -> encoding_statistics {
+	return __internal::label_cover_block_statistics(__internal::distinct_label_cover_blocks(csp));
+}
+
+auto multivalued_label_cover_encoding_statistics(csp const& csp) -> encoding_statistics {
+	return __internal::multivalued_label_cover_block_statistics(
+		__internal::distinct_label_cover_blocks(csp));
+}
+
+auto decode_label_cover_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value> {
+	// entry variables follow the variable assignments, which are laid out as in the direct
+	// encoding
+	return __internal::decode_one_hot(csp, _assignment);
+}
+
+auto label_cover_encoding(csp const& original) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("label_cover");
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto csp = __internal::share_label_cover_blocks(original);
+	const auto n_clauses = __internal::label_cover_block_statistics(csp).n_clauses;
 
 	auto clauses = std::vector<clause>{};
 	clauses.reserve(n_clauses);
@@ -96,23 +115,16 @@ auto label_cover_encoding(csp const& csp) -> sat {
 
 	assert(n_clauses == clauses.size());
 
+	metrics.clauses.record(clauses.size());
 	return sat(std::move(clauses));
 }
 
-auto multivalued_label_cover_encoding(csp const& csp) -> sat {
-	// clang-format off
-	auto n_clauses =
-		// at most one var
-		csp.n_variables() * gautil::n_choose_k(csp.domain_size(), 2) +
-		// at least one var
-		gautil::fold(csp.constraints(), 0u, std::plus{}, &constraint::arity) +
-		// at least one entry in relation
-		csp.constraints().size() +
-		// implication
-		gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
-			return constraint.get_relation().size() * constraint.arity();
-		});
-	// clang-format on
+auto multivalued_label_cover_encoding(csp const& original) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("multivalued_label_cover");
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto csp = __internal::share_label_cover_blocks(original);
+	const auto n_clauses = __internal::multivalued_label_cover_block_statistics(csp).n_clauses;
 
 	auto clauses = std::vector<clause>{};
 	clauses.reserve(n_clauses);
@@ -124,6 +136,77 @@ auto multivalued_label_cover_encoding(csp const& csp) -> sat {
 
 	assert(n_clauses == clauses.size());
 
+	metrics.clauses.record(clauses.size());
 	return sat(std::move(clauses));
 }
-} // namespace cspc
\ No newline at end of file
+
+namespace __internal {
+auto parallel_label_cover_encoding(
+	csp const& original, size_t n_threads, bool multivalued, encoding_metrics const& metrics)
+	-> sat {
+	const auto timer = scoped_timer(metrics.seconds);
+
+	const auto csp = share_label_cover_blocks(original);
+	const auto domain_size = csp.domain_size();
+	const auto constraints = std::span(csp.constraints());
+	const auto n_clauses = multivalued ? multivalued_label_cover_block_statistics(csp).n_clauses
+									   : label_cover_block_statistics(csp).n_clauses;
+
+	auto clauses = std::vector<clause>{};
+	clauses.reserve(n_clauses);
+
+	__internal::at_most_one_clauses(csp, std::back_inserter(clauses));
+	__internal::at_least_one_clauses(csp, std::back_inserter(clauses));
+
+	// the entry variables of constraint i start at entry_offsets[i]
+	auto entry_offsets = std::vector<size_t>{};
+	entry_offsets.reserve(constraints.size());
+	auto n_entries = csp.n_variables() * domain_size;
+	for (auto const& constraint : constraints) {
+		entry_offsets.push_back(n_entries);
+		n_entries += constraint.relation_size();
+	}
+	auto counts = std::vector<size_t>(constraints.size());
+
+	if (!multivalued) {
+		std::ranges::transform(constraints, counts.begin(), [](auto const& constraint) {
+			return gautil::n_choose_k(constraint.relation_size(), 2);
+		});
+		__internal::fill_clauses_in_parallel(
+			clauses, counts, n_threads, [&](size_t begin, size_t end, auto out) {
+				__internal::at_most_one_entry_clauses(
+					constraints.subspan(begin, end - begin), entry_offsets[begin], out);
+			});
+	}
+	__internal::at_least_one_entry_clauses(csp, std::back_inserter(clauses));
+	std::ranges::transform(constraints, counts.begin(), [](auto const& constraint) {
+		return constraint.relation_size() * constraint.arity();
+	});
+	__internal::fill_clauses_in_parallel(
+		clauses, counts, n_threads, [&](size_t begin, size_t end, auto out) {
+			__internal::implication_clauses(
+				constraints.subspan(begin, end - begin), domain_size, entry_offsets[begin], out);
+		});
+
+	assert(n_clauses == clauses.size());
+
+	metrics.clauses.record(clauses.size());
+	return sat(std::move(clauses));
+}
+} // namespace __internal
+
+auto create_parallel_label_cover_encoding(size_t n_threads) -> encoding {
+	return [n_threads](csp const& csp) {
+		static const auto metrics = __internal::create_encoding_metrics("parallel_label_cover");
+		return __internal::parallel_label_cover_encoding(csp, n_threads, false, metrics);
+	};
+}
+
+auto create_parallel_multivalued_label_cover_encoding(size_t n_threads) -> encoding {
+	return [n_threads](csp const& csp) {
+		static const auto metrics =
+			__internal::create_encoding_metrics("parallel_multivalued_label_cover");
+		return __internal::parallel_label_cover_encoding(csp, n_threads, true, metrics);
+	};
+}
+} // namespace cspc
@@ -0,0 +1,222 @@
+#include "cspc/encodings/mdd.hpp"
+
+#include "cspc/encodings/common.hpp"
+#include <gautil/functional.hpp>
+#include <gautil/math.hpp>
+#include <map>
+#include <unordered_map>
+
+namespace cspc {
+namespace __internal {
+auto mdd::has_single_child(u32 node) const -> bool {
+	const auto first = child(node, 0);
+	if (first == MDD_ACCEPT || first == MDD_REJECT) {
+		return false;
+	}
+	for (auto a = domain_value(1); a < domain_size; ++a) {
+		if (child(node, a) != first) {
+			return false;
+		}
+	}
+	return true;
+}
+
+class mdd_builder {
+  public:
+	mdd_builder(std::vector<relation_entry> tuples, size_t arity, size_t domain_size)
+		: m_tuples{std::move(tuples)}, m_diagram{arity, domain_size, {}, {}} {
+		std::ranges::sort(m_tuples);
+		const auto [first, last] = std::ranges::unique(m_tuples);
+		m_tuples.erase(first, last);
+	}
+
+	auto build() -> mdd {
+		const auto root = build(0, 0, m_tuples.size());
+		if (root == MDD_ACCEPT || root == MDD_REJECT) {
+			// the relation is empty or full; the root still needs to branch on the first value
+			add_node(0, std::vector<u32>(m_diagram.domain_size, root));
+		}
+		return std::move(m_diagram);
+	}
+
+  private:
+	// the node of the tuples [begin, end), which share their first `layer` values
+	auto build(size_t layer, size_t begin, size_t end) -> u32 {
+		if (begin == end) {
+			return MDD_REJECT;
+		}
+		if (layer == m_diagram.arity) {
+			return MDD_ACCEPT;
+		}
+		auto children = std::vector<u32>(m_diagram.domain_size, MDD_REJECT);
+		for (auto i = begin; i < end;) {
+			const auto value = m_tuples[i][layer];
+			auto j = i;
+			while (j < end && m_tuples[j][layer] == value) {
+				++j;
+			}
+			children[value] = build(layer + 1, i, j);
+			i = j;
+		}
+		if (std::ranges::all_of(children, [&](u32 c) { return c == children[0]; }) &&
+			(children[0] == MDD_ACCEPT || children[0] == MDD_REJECT)) {
+			return children[0];
+		}
+		return add_node(layer, std::move(children));
+	}
+
+	auto add_node(size_t layer, std::vector<u32> children) -> u32 {
+		auto key = children;
+		key.push_back(u32(layer));
+		const auto [it, inserted] = m_unique.try_emplace(std::move(key), u32(m_diagram.n_nodes()));
+		if (inserted) {
+			m_diagram.children.insert(m_diagram.children.end(), children.begin(), children.end());
+			m_diagram.layers.push_back(u32(layer));
+		}
+		return it->second;
+	}
+
+	std::vector<relation_entry> m_tuples;
+	mdd m_diagram;
+	// the node of every distinct (children, layer)
+	std::map<std::vector<u32>, u32> m_unique;
+};
+
+auto compile_mdd(relation const& _relation, size_t domain_size) -> mdd {
+	static auto& compile_time = global_metrics().histogram(
+		"cspc_mdd_compile_seconds", "Time taken to compile a relation into a decision diagram",
+		METRIC_SECONDS);
+	const auto timer = scoped_timer(compile_time);
+	auto tuples = std::vector<relation_entry>(_relation.begin(), _relation.end());
+	return mdd_builder(std::move(tuples), _relation.arity(), domain_size).build();
+}
+
+auto mdd_instance_statistics_of(mdd const& diagram) -> mdd_instance_statistics {
+	auto statistics = mdd_instance_statistics{
+		.n_variables = diagram.n_nodes() - 1,
+		.n_clauses = 0,
+		.n_literals = 0,
+	};
+	for (auto node = u32(0); node < diagram.n_nodes(); ++node) {
+		const auto reached = node == diagram.root() ? 0ul : 1ul;
+		if (diagram.has_single_child(node)) {
+			statistics.n_clauses += 1;
+			statistics.n_literals += reached + 1;
+			continue;
+		}
+		for (auto a = domain_value(0); a < diagram.domain_size; ++a) {
+			const auto child = diagram.child(node, a);
+			if (child == MDD_REJECT) {
+				statistics.n_clauses += 1;
+				statistics.n_literals += reached + 1;
+			} else if (child != MDD_ACCEPT) {
+				statistics.n_clauses += 1;
+				statistics.n_literals += reached + 2;
+			}
+		}
+	}
+	return statistics;
+}
+
+// the diagram of each distinct relation of a csp, so that the constraints sharing a relation
+// share its compilation
+class mdd_cache {
+  public:
+	explicit mdd_cache(size_t domain_size) : m_domain_size{domain_size} {}
+
+	auto find(relation const& _relation) -> std::pair<mdd const&, mdd_instance_statistics> {
+		auto it = m_diagrams.find(_relation);
+		if (it == m_diagrams.end()) {
+			auto diagram = compile_mdd(_relation, m_domain_size);
+			const auto statistics = mdd_instance_statistics_of(diagram);
+			it = m_diagrams.emplace(_relation, std::pair(std::move(diagram), statistics)).first;
+		}
+		return {it->second.first, it->second.second};
+	}
+
+  private:
+	size_t m_domain_size;
+	std::unordered_map<relation, std::pair<mdd, mdd_instance_statistics>> m_diagrams;
+};
+
+// compiles every distinct relation into `cache`, so that encoding afterwards reuses the diagrams
+auto mdd_statistics(csp const& csp, bool multivalued, mdd_cache& cache) -> encoding_statistics {
+	const auto domain_size = csp.domain_size();
+	auto n_node_variables = size_t(0);
+	auto n_mdd_clauses = size_t(0);
+	auto n_mdd_literals = size_t(0);
+	for (auto const& constraint : csp.constraints()) {
+		const auto statistics = cache.find(constraint.get_relation()).second;
+		n_node_variables += statistics.n_variables;
+		n_mdd_clauses += statistics.n_clauses;
+		n_mdd_literals += statistics.n_literals;
+	}
+	const auto n_at_most_one_clauses =
+		multivalued ? 0 : csp.n_variables() * gautil::n_choose_k(domain_size, 2);
+	return encoding_statistics{
+		.n_variables = csp.n_variables() * domain_size + n_node_variables,
+		.n_clauses = n_at_most_one_clauses + csp.n_variables() + n_mdd_clauses,
+		.n_literals =
+			2 * n_at_most_one_clauses + csp.n_variables() * domain_size + n_mdd_literals,
+		.relation_density = __internal::mean_relation_density(csp),
+	};
+}
+
+auto mdd_encoding(csp const& csp, bool multivalued, encoding_metrics const& metrics) -> sat {
+	const auto timer = scoped_timer(metrics.seconds);
+
+	auto cache = mdd_cache(csp.domain_size());
+	const auto n_clauses = mdd_statistics(csp, multivalued, cache).n_clauses;
+
+	auto clauses = std::vector<clause>{};
+	clauses.reserve(n_clauses);
+
+	if (!multivalued) {
+		__internal::at_most_one_clauses(csp, std::back_inserter(clauses));
+	}
+	__internal::at_least_one_clauses(csp, std::back_inserter(clauses));
+
+	auto first_node_variable = csp.n_variables() * csp.domain_size();
+	for (auto const& constraint : csp.constraints()) {
+		const auto [diagram, statistics] = cache.find(constraint.get_relation());
+		__internal::mdd_clauses(
+			diagram, constraint.variables(), first_node_variable, std::back_inserter(clauses));
+		first_node_variable += statistics.n_variables;
+	}
+
+	assert(n_clauses == clauses.size());
+
+	metrics.clauses.record(clauses.size());
+	return sat(std::move(clauses));
+}
+} // namespace __internal
+
+auto mdd_encoding_statistics(csp const& csp) -> encoding_statistics {
+	auto cache = __internal::mdd_cache(csp.domain_size());
+	return __internal::mdd_statistics(csp, false, cache);
+}
+
+auto multivalued_mdd_encoding_statistics(csp const& csp) -> encoding_statistics {
+	auto cache = __internal::mdd_cache(csp.domain_size());
+	return __internal::mdd_statistics(csp, true, cache);
+}
+
+auto decode_mdd_assignment(csp const& csp, assignment const& _assignment)
+	-> std::vector<domain_value> {
+	// node variables follow the variable assignments, which are laid out as in the direct
+	// encoding
+	return __internal::decode_one_hot(csp, _assignment);
+}
+
+auto mdd_encoding(csp const& csp) -> sat {
+	static const auto metrics = __internal::create_encoding_metrics("mdd");
+	return __internal::mdd_encoding(csp, false, metrics);
+}
+
+auto multivalued_mdd_encoding(csp const& csp) -> sat {
+	// every combination of the values assigned to the scope reaches the accept terminal, as
+	// reaching a node and assigning any value implies reaching the child
+	static const auto metrics = __internal::create_encoding_metrics("multivalued_mdd");
+	return __internal::mdd_encoding(csp, true, metrics);
+}
+} // namespace cspc
@@ -0,0 +1,267 @@
+#include "cspc/external_solver.hpp"
+
+#include "cspc/metrics.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <poll.h>
+#include <signal.h>
+#include <spdlog/spdlog.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace cspc {
+auto to_dimacs(sat const& sat) -> std::string {
+	auto n_variables = u32(0);
+	for (auto const& _clause : sat.clauses()) {
+		for (auto const& lit : _clause) {
+			n_variables = std::max(n_variables, lit.variable());
+		}
+	}
+	auto dimacs = fmt::format("p cnf {} {}\n", n_variables, sat.clauses().size());
+	for (auto const& _clause : sat.clauses()) {
+		for (auto const& lit : _clause) {
+			fmt::format_to(std::back_inserter(dimacs), "{} ", lit.value);
+		}
+		dimacs += "0\n";
+	}
+	return dimacs;
+}
+
+auto parse_dimacs_result(std::string_view output) -> std::optional<satisfiability> {
+	while (!output.empty()) {
+		const auto end = output.find('\n');
+		auto line = output.substr(0, end);
+		output = end == std::string_view::npos ? std::string_view{} : output.substr(end + 1);
+		while (!line.empty() && std::isspace((unsigned char)line.back())) {
+			line.remove_suffix(1);
+		}
+		if (line == "s SATISFIABLE") {
+			return SATISFIABLE;
+		}
+		if (line == "s UNSATISFIABLE") {
+			return UNSATISFIABLE;
+		}
+	}
+	return std::nullopt;
+}
+
+namespace __internal {
+using deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+struct solver_process {
+	pid_t pid;
+	int fd; // the child's standard input and output
+};
+
+auto start_solver_process(external_solver_options const& options) -> std::optional<solver_process> {
+	auto argv = std::vector<char*>{};
+	argv.reserve(options.command.size() + 1);
+	for (auto const& argument : options.command) {
+		argv.push_back(const_cast<char*>(argument.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	// a socket rather than pipes, so that writing to a solver that died fails instead of raising
+	// SIGPIPE
+	int fds[2];
+	if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+		spdlog::error("Failed to create a socket pair: {}", strerror(errno));
+		return std::nullopt;
+	}
+	const auto pid = fork();
+	if (pid == 0) {
+		// only async-signal-safe calls until exec
+		::dup2(fds[1], STDIN_FILENO);
+		::dup2(fds[1], STDOUT_FILENO);
+		const auto null = ::open("/dev/null", O_WRONLY);
+		if (null >= 0) {
+			::dup2(null, STDERR_FILENO);
+		}
+		if (options.memory_limit_bytes > 0) {
+			const auto limit = rlimit{options.memory_limit_bytes, options.memory_limit_bytes};
+			::setrlimit(RLIMIT_AS, &limit);
+		}
+		execvp(argv[0], argv.data());
+		// only reached if exec failed
+		_exit(127);
+	}
+	::close(fds[1]);
+	if (pid < 0) {
+		spdlog::error("Failed to call fork() with error: {}", strerror(errno));
+		::close(fds[0]);
+		return std::nullopt;
+	}
+	return solver_process{.pid = pid, .fd = fds[0]};
+}
+
+auto milliseconds_until(deadline const& _deadline) -> int {
+	if (!_deadline.has_value()) {
+		return -1;
+	}
+	const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+		_deadline.value() - std::chrono::steady_clock::now());
+	return int(std::max(remaining.count(), i64(0)));
+}
+
+// writes the input while reading the output, as a solver may start writing before it has read
+// everything; nothing if the deadline passed first
+auto exchange(int fd, std::string const& input, deadline const& _deadline)
+	-> std::optional<std::string> {
+	::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+	auto output = std::string{};
+	auto n_written = size_t(0);
+	if (input.empty()) {
+		::shutdown(fd, SHUT_WR);
+	}
+	while (true) {
+		auto request = pollfd{
+			.fd = fd,
+			.events = short(POLLIN | (n_written < input.size() ? POLLOUT : 0)),
+			.revents = 0,
+		};
+		const auto n_ready = ::poll(&request, 1, milliseconds_until(_deadline));
+		if (n_ready < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n_ready <= 0) {
+			return std::nullopt;
+		}
+		if ((request.revents & POLLOUT) != 0) {
+			const auto n_sent = ::send(
+				fd, input.data() + n_written, input.size() - n_written, MSG_NOSIGNAL);
+			if (n_sent >= 0) {
+				n_written += size_t(n_sent);
+			} else if (errno != EAGAIN && errno != EINTR) {
+				// the solver stopped reading, its exit status tells why
+				n_written = input.size();
+			}
+			if (n_written == input.size()) {
+				::shutdown(fd, SHUT_WR);
+			}
+		}
+		if ((request.revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+			char buffer[4096];
+			const auto n_received = ::recv(fd, buffer, sizeof(buffer), 0);
+			if (n_received > 0) {
+				output.append(buffer, size_t(n_received));
+			} else if (n_received == 0 || (errno != EAGAIN && errno != EINTR)) {
+				return output;
+			}
+		}
+	}
+}
+
+// the exit status, or nothing if the process was still running at the deadline and was killed
+auto wait_for_exit(pid_t pid, deadline const& _deadline) -> std::optional<int> {
+	auto status = int{0};
+	while (true) {
+		const auto options = _deadline.has_value() ? WNOHANG : 0;
+		const auto result = ::waitpid(pid, &status, options);
+		if (result == pid) {
+			return status;
+		}
+		if (result < 0 && errno != EINTR) {
+			spdlog::error("Failed to call waitpid(...) with error: {}", strerror(errno));
+			return std::nullopt;
+		}
+		if (_deadline.has_value() && std::chrono::steady_clock::now() >= _deadline.value()) {
+			::kill(pid, SIGKILL);
+			::waitpid(pid, &status, 0);
+			return std::nullopt;
+		}
+		if (result == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+auto run_solver_process(external_solver_options const& options, std::string const& input)
+	-> std::optional<satisfiability> {
+	const auto _deadline = options.time_limit.count() > 0
+							   ? deadline{std::chrono::steady_clock::now() + options.time_limit}
+							   : std::nullopt;
+	const auto process = start_solver_process(options);
+	if (!process.has_value()) {
+		return std::nullopt;
+	}
+	const auto output = exchange(process->fd, input, _deadline);
+	::close(process->fd);
+	if (!output.has_value()) {
+		::kill(process->pid, SIGKILL);
+	}
+	const auto status = wait_for_exit(process->pid, _deadline);
+	if (!output.has_value() || !status.has_value() || !WIFEXITED(status.value())) {
+		return std::nullopt;
+	}
+	const auto result = parse_dimacs_result(output.value());
+	if (result.has_value()) {
+		return result;
+	}
+	// the competition exit codes, for solvers that print no result line
+	switch (WEXITSTATUS(status.value())) {
+	case 10:
+		return SATISFIABLE;
+	case 20:
+		return UNSATISFIABLE;
+	default:
+		return std::nullopt;
+	}
+}
+} // namespace __internal
+
+auto external_solver_pool::solve(sat const& sat) -> std::optional<satisfiability> {
+	static auto& solve_time = global_metrics().histogram(
+		"cspc_external_solve_seconds", "Time taken by an external solver process",
+		METRIC_SECONDS);
+	static auto& n_failures = global_metrics().counter(
+		"cspc_external_solver_failures_total",
+		"Instances an external solver crashed on, ran out of limits on or did not decide");
+
+	// encoded before taking a process slot
+	const auto input = to_dimacs(sat);
+	{
+		auto lock = std::unique_lock(m_mutex);
+		m_slot_freed.wait(
+			lock, [&]() { return m_n_running < std::max(m_options.max_processes, size_t(1)); });
+		++m_n_running;
+	}
+	auto result = std::optional<satisfiability>{};
+	{
+		const auto timer = scoped_timer(solve_time);
+		result = __internal::run_solver_process(m_options, input);
+	}
+	{
+		const auto lock = std::scoped_lock(m_mutex);
+		--m_n_running;
+	}
+	m_slot_freed.notify_one();
+
+	if (!result.has_value()) {
+		n_failures.add(1);
+	}
+	return result;
+}
+
+auto external_solver_pool::n_running() const -> size_t {
+	const auto lock = std::scoped_lock(m_mutex);
+	return m_n_running;
+}
+
+auto create_external_solver(std::shared_ptr<external_solver_pool> pool, solver fallback)
+	-> solver {
+	return [pool, fallback](sat const& sat) {
+		const auto result = pool->solve(sat);
+		if (result.has_value()) {
+			return result.value();
+		}
+		spdlog::warn("External solver failed, falling back");
+		return fallback(sat);
+	};
+}
+} // namespace cspc
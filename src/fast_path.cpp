@@ -0,0 +1,173 @@
+#include "cspc/fast_path.hpp"
+
+#include "cspc/algorithms.hpp"
+#include "cspc/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace cspc {
+namespace __internal {
+auto has_identity_variables(operation const& _operation) -> bool {
+	return std::ranges::any_of(_operation.identities, [](identity const& identity) {
+		return !identity.variables.empty();
+	});
+}
+
+// true if both sides of every identity use the same set of variables, as then any semilattice
+// operation satisfies them
+auto identities_are_balanced(operation const& _operation) -> bool {
+	if (has_identity_variables(_operation)) {
+		return false;
+	}
+	return std::ranges::all_of(_operation.identities, [](identity const& identity) {
+		if (identity.inputs.empty()) {
+			return true;
+		}
+		const auto variables_of = [](std::vector<variable> const& input) {
+			return std::set<variable>(input.begin(), input.end());
+		};
+		const auto first = variables_of(identity.inputs.front());
+		return std::ranges::all_of(identity.inputs, [&](auto const& input) {
+			return variables_of(input) == first;
+		});
+	});
+}
+
+auto sorted_unique_entries(relation const& _relation) -> std::vector<relation_entry> {
+	auto entries = _relation.data();
+	std::ranges::sort(entries);
+	const auto [first, last] = std::ranges::unique(entries);
+	entries.erase(first, last);
+	return entries;
+}
+
+template <typename BinaryOperation>
+auto is_closed_under(std::vector<relation_entry> const& sorted_entries, BinaryOperation op)
+	-> bool {
+	for (auto const& lhs : sorted_entries) {
+		for (auto const& rhs : sorted_entries) {
+			auto image = relation_entry(lhs.length());
+			std::ranges::transform(lhs, rhs, image.begin(), op);
+			if (!std::ranges::binary_search(sorted_entries, image)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+} // namespace __internal
+
+auto empty_relation_rule() -> fast_path_rule {
+	// every operation preserves the empty relation, and the constant operations satisfy any
+	// identities without variables
+	return {"empty relation", [](operation const& _operation, relation const& _relation) {
+				if (!_relation.empty() || __internal::has_identity_variables(_operation)) {
+					return std::optional<satisfiability>{};
+				}
+				return std::optional{SATISFIABLE};
+			}};
+}
+
+auto full_relation_rule() -> fast_path_rule {
+	// every operation preserves D^n
+	return {"full relation", [](operation const& _operation, relation const& _relation) {
+				if (_relation.empty() || __internal::has_identity_variables(_operation)) {
+					return std::optional<satisfiability>{};
+				}
+				const auto domain_size = __internal::find_relation_domain_size(_relation);
+				const auto n_tuples = (size_t)std::pow(domain_size, _relation.arity());
+				if (_relation.size() < n_tuples ||
+					__internal::sorted_unique_entries(_relation).size() != n_tuples) {
+					return std::optional<satisfiability>{};
+				}
+				return std::optional{SATISFIABLE};
+			}};
+}
+
+auto constant_tuple_rule() -> fast_path_rule {
+	// if (a, ..., a) is in the relation then the constant operation a preserves it
+	return {"constant tuple", [](operation const& _operation, relation const& _relation) {
+				if (__internal::has_identity_variables(_operation)) {
+					return std::optional<satisfiability>{};
+				}
+				const auto is_constant = [](relation_entry const& entry) {
+					return std::ranges::adjacent_find(entry, std::not_equal_to{}) == entry.end();
+				};
+				if (std::ranges::none_of(_relation, is_constant)) {
+					return std::optional<satisfiability>{};
+				}
+				return std::optional{SATISFIABLE};
+			}};
+}
+
+auto semilattice_rule() -> fast_path_rule {
+	// min and max satisfy every identity whose sides use the same variables
+	return {"semilattice", [](operation const& _operation, relation const& _relation) {
+				if (!__internal::identities_are_balanced(_operation)) {
+					return std::optional<satisfiability>{};
+				}
+				const auto entries = __internal::sorted_unique_entries(_relation);
+				const auto min = [](domain_value a, domain_value b) { return std::min(a, b); };
+				const auto max = [](domain_value a, domain_value b) { return std::max(a, b); };
+				if (!__internal::is_closed_under(entries, min) &&
+					!__internal::is_closed_under(entries, max)) {
+					return std::optional<satisfiability>{};
+				}
+				return std::optional{SATISFIABLE};
+			}};
+}
+
+auto default_fast_path_rules() -> std::vector<fast_path_rule> {
+	return {
+		empty_relation_rule(),
+		full_relation_rule(),
+		constant_tuple_rule(),
+		semilattice_rule(),
+	};
+}
+
+auto classify_fast_path(
+	operation const& _operation, relation const& _relation, std::vector<fast_path_rule> const& rules)
+	-> std::optional<fast_path_decision> {
+	for (auto i = size_t(0); i < rules.size(); ++i) {
+		const auto result = rules[i].decide(_operation, _relation);
+		if (result.has_value()) {
+			return fast_path_decision{.rule = i, .result = result.value()};
+		}
+	}
+	return std::nullopt;
+}
+
+auto create_fast_path_checker(
+	operation const& _operation,
+	std::vector<fast_path_rule> rules,
+	polymorphism_checker checker,
+	std::shared_ptr<fast_path_statistics> statistics) -> polymorphism_checker {
+	auto global_hits = std::vector<metric_counter*>{};
+	for (auto const& rule : rules) {
+		global_hits.push_back(&global_metrics().counter(
+			"cspc_fast_path_hits_total", "Relations decided by a fast path rule",
+			{{"rule", rule.name}}));
+	}
+	auto& global_misses = global_metrics().counter(
+		"cspc_fast_path_misses_total", "Relations that no fast path rule decided");
+	return [_operation, rules = std::move(rules), checker = std::move(checker),
+			statistics = std::move(statistics), global_hits = std::move(global_hits),
+			&global_misses](relation const& _relation) {
+		const auto decision = classify_fast_path(_operation, _relation, rules);
+		if (!decision.has_value()) {
+			if (statistics) {
+				statistics->record_miss();
+			}
+			global_misses.add();
+			return checker(_relation);
+		}
+		if (statistics) {
+			statistics->record_hit(decision->rule);
+		}
+		global_hits[decision->rule]->add();
+		return decision->result;
+	};
+}
+} // namespace cspc
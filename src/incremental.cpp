@@ -0,0 +1,208 @@
+#include "cspc/incremental.hpp"
+
+#include "cspc/algorithms.hpp"
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace cspc {
+incremental_meta_csp::incremental_meta_csp(
+	operation const& _operation, size_t arity, size_t domain_size, encoding _encoding)
+	: m_operation_arity{_operation.arity}, m_arity{arity}, m_domain_size{domain_size},
+	  m_n_tuples{(size_t)std::pow(domain_size, arity)},
+	  m_identity_clauses{[&]() {
+		  // the function table followed by one variable per domain value, as in
+		  // construct_preserves_operation_csp
+		  const auto n_variables = (size_t)std::pow(domain_size, _operation.arity) + domain_size;
+		  const auto identity_constraints =
+			  __internal::construct_operation_identity_constraints(_operation, domain_size);
+		  return _encoding(csp(identity_constraints, n_variables, domain_size));
+	  }()},
+	  m_contains(m_n_tuples) {
+	m_tuples.reserve(m_n_tuples);
+	for (auto t = domain_value(0); t < m_n_tuples; ++t) {
+		m_tuples.push_back(__internal::index_to_function_input(t, arity, domain_size));
+	}
+}
+
+template <typename Function>
+auto incremental_meta_csp::for_each_scope(std::optional<u32> row, Function fn) const -> void {
+	if (m_rows.empty()) {
+		return;
+	}
+	const auto n_iterations = (size_t)std::pow(m_rows.size(), m_operation_arity);
+	auto choice = std::vector<size_t>(m_operation_arity);
+	auto scope = std::vector<variable>(m_arity);
+	for (auto iteration = size_t(0); iteration < n_iterations; ++iteration) {
+		const auto includes_row = !row.has_value() || std::ranges::any_of(choice, [&](size_t i) {
+			return m_rows[i] == row.value();
+		});
+		if (includes_row) {
+			// the k:th chosen row is the k:th argument of the operation in every column
+			auto key = u64(0);
+			std::ranges::fill(scope, 0);
+			for (auto k = size_t(0); k < m_operation_arity; ++k) {
+				const auto& tuple = m_tuples[m_rows[choice[k]]];
+				for (auto j = size_t(0); j < m_arity; ++j) {
+					scope[j] = scope[j] * m_domain_size + tuple[j];
+				}
+				key = key * m_n_tuples + m_rows[choice[k]];
+			}
+			fn(key, scope);
+		}
+
+		for (auto& i : choice) {
+			if (++i < m_rows.size()) {
+				break;
+			}
+			i = 0;
+		}
+	}
+}
+
+auto incremental_meta_csp::conflict_clause(std::vector<variable> const& scope, u32 nogood) const
+	-> clause {
+	auto _clause = clause{};
+	_clause.reserve(m_arity);
+	for (auto j = size_t(0); j < m_arity; ++j) {
+		_clause.push_back(literal(scope[j] * m_domain_size + m_tuples[nogood][j], NEGATED));
+	}
+	return _clause;
+}
+
+auto incremental_meta_csp::add_clause(u64 key, clause _clause, clause_delta& delta) -> void {
+	m_clause_positions[key] = m_clauses.size();
+	m_clause_keys.push_back(key);
+	delta.added.push_back(_clause);
+	m_clauses.push_back(std::move(_clause));
+}
+
+auto incremental_meta_csp::remove_clause(u64 key, clause_delta& delta) -> void {
+	const auto it = m_clause_positions.find(key);
+	const auto position = it->second;
+	m_clause_positions.erase(it);
+
+	// move the last clause into the gap
+	delta.removed.push_back(std::move(m_clauses[position]));
+	if (position + 1 < m_clauses.size()) {
+		m_clauses[position] = std::move(m_clauses.back());
+		m_clause_keys[position] = m_clause_keys.back();
+		m_clause_positions[m_clause_keys[position]] = position;
+	}
+	m_clauses.pop_back();
+	m_clause_keys.pop_back();
+}
+
+auto incremental_meta_csp::insert(relation_entry const& tuple) -> clause_delta {
+	const auto t = __internal::function_input_to_index(tuple, m_domain_size);
+	auto delta = clause_delta{};
+	if (m_contains[t]) {
+		return delta;
+	}
+
+	// the tuple is no longer a nogood of the existing scopes
+	for_each_scope(std::nullopt, [&](u64 key, std::vector<variable> const&) {
+		remove_clause(key * m_n_tuples + t, delta);
+	});
+
+	m_contains[t] = true;
+	m_rows.push_back(t);
+
+	// the scopes that use the new row forbid every tuple outside the relation
+	for_each_scope(t, [&](u64 key, std::vector<variable> const& scope) {
+		for (auto nogood = u32(0); nogood < m_n_tuples; ++nogood) {
+			if (!m_contains[nogood]) {
+				add_clause(key * m_n_tuples + nogood, conflict_clause(scope, nogood), delta);
+			}
+		}
+	});
+	return delta;
+}
+
+auto incremental_meta_csp::erase(relation_entry const& tuple) -> clause_delta {
+	const auto t = __internal::function_input_to_index(tuple, m_domain_size);
+	auto delta = clause_delta{};
+	if (!m_contains[t]) {
+		return delta;
+	}
+
+	// the scopes that use the row disappear
+	for_each_scope(t, [&](u64 key, std::vector<variable> const&) {
+		for (auto nogood = u32(0); nogood < m_n_tuples; ++nogood) {
+			if (!m_contains[nogood]) {
+				remove_clause(key * m_n_tuples + nogood, delta);
+			}
+		}
+	});
+
+	m_contains[t] = false;
+	m_rows.erase(std::ranges::find(m_rows, t));
+
+	// and the tuple becomes a nogood of the remaining ones
+	for_each_scope(std::nullopt, [&](u64 key, std::vector<variable> const& scope) {
+		add_clause(key * m_n_tuples + t, conflict_clause(scope, t), delta);
+	});
+	return delta;
+}
+
+auto incremental_meta_csp::assign(relation const& _relation) -> clause_delta {
+	auto target = std::vector<bool>(m_n_tuples);
+	for (auto const& entry : _relation) {
+		target[__internal::function_input_to_index(entry, m_domain_size)] = true;
+	}
+
+	auto delta = clause_delta{};
+	const auto append = [&](clause_delta step) {
+		std::ranges::move(step.added, std::back_inserter(delta.added));
+		std::ranges::move(step.removed, std::back_inserter(delta.removed));
+	};
+	for (auto t = u32(0); t < m_n_tuples; ++t) {
+		if (m_contains[t] && !target[t]) {
+			append(erase(m_tuples[t]));
+		}
+	}
+	for (auto t = u32(0); t < m_n_tuples; ++t) {
+		if (!m_contains[t] && target[t]) {
+			append(insert(m_tuples[t]));
+		}
+	}
+	return delta;
+}
+
+auto incremental_meta_csp::current_relation() const -> relation {
+	auto result = relation(m_arity);
+	for (auto const t : m_rows) {
+		result.insert(m_tuples[t]);
+	}
+	return result;
+}
+
+auto incremental_meta_csp::encoded() const -> sat {
+	auto clauses = std::vector<clause>{};
+	clauses.reserve(m_identity_clauses.clauses().size() + m_clauses.size());
+	std::ranges::copy(m_identity_clauses.clauses(), std::back_inserter(clauses));
+	std::ranges::copy(m_clauses, std::back_inserter(clauses));
+	return sat(std::move(clauses));
+}
+
+auto create_incremental_encoding_solver(
+	operation const& _operation, size_t domain_size, encoding _encoding, solver _solver)
+	-> polymorphism_checker {
+	struct state {
+		std::mutex mutex;
+		std::unique_ptr<incremental_meta_csp> meta_csp;
+	};
+	const auto _state = std::make_shared<state>();
+	return [_operation, domain_size, _encoding, _solver, _state](relation const& _relation) {
+		if (!_relation.empty() && __internal::find_relation_domain_size(_relation) > domain_size) {
+			return _solver(_encoding(construct_preserves_operation_csp(_operation, _relation)));
+		}
+		auto lock = std::scoped_lock(_state->mutex);
+		if (_state->meta_csp == nullptr || _state->meta_csp->arity() != _relation.arity()) {
+			_state->meta_csp = std::make_unique<incremental_meta_csp>(
+				_operation, _relation.arity(), domain_size, _encoding);
+		}
+		_state->meta_csp->assign(_relation);
+		return _solver(_state->meta_csp->encoded());
+	};
+}
+} // namespace cspc
@@ -0,0 +1,46 @@
+#include "cspc/intern.hpp"
+
+#include "cspc/metrics.hpp"
+#include <mutex>
+#include <unordered_set>
+
+namespace cspc {
+namespace __internal {
+struct intern_table {
+	std::mutex mutex;
+	// nodes of an unordered_set keep their address when it rehashes
+	std::unordered_set<relation> relations;
+};
+
+auto global_intern_table() -> intern_table& {
+	static auto table = intern_table{};
+	return table;
+}
+} // namespace __internal
+
+auto intern(relation const& _relation) -> interned_relation {
+	static auto& n_lookups = global_metrics().counter(
+		"cspc_interned_relation_lookups_total", "Relations looked up in the interning table");
+	n_lookups.add(1);
+
+	auto& table = __internal::global_intern_table();
+	{
+		const auto lock = std::scoped_lock(table.mutex);
+		const auto it = table.relations.find(_relation);
+		if (it != table.relations.end()) {
+			return interned_relation(&*it);
+		}
+	}
+	// sorted outside of the lock, as the relation is most likely new
+	auto sorted = _relation;
+	sorted.sort();
+	const auto lock = std::scoped_lock(table.mutex);
+	return interned_relation(&*table.relations.insert(std::move(sorted)).first);
+}
+
+auto n_interned_relations() -> size_t {
+	auto& table = __internal::global_intern_table();
+	const auto lock = std::scoped_lock(table.mutex);
+	return table.relations.size();
+}
+} // namespace cspc
@@ -0,0 +1,165 @@
+#include "cspc/journal.hpp"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <string.h>
+#include <unistd.h>
+
+namespace cspc {
+namespace __internal {
+auto journal_header(std::string const& parameters) -> std::string {
+	return fmt::format("# cspc journal {}\n", parameters);
+}
+
+// the length of the file up to and including its last complete line, and the records on it
+auto read_journal(std::filesystem::path const& path, std::string const& parameters)
+	-> std::optional<std::pair<size_t, std::vector<journal_entry>>> {
+	auto ifs = std::ifstream(path, std::ios::binary);
+	const auto contents =
+		std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	const auto header = journal_header(parameters);
+	if (!contents.starts_with(header)) {
+		spdlog::error("{} is not a journal for parameters \"{}\"", path.string(), parameters);
+		return std::nullopt;
+	}
+
+	const auto complete_length = contents.rfind('\n') + 1;
+	auto entries = std::vector<journal_entry>{};
+	auto lines = std::istringstream(contents.substr(header.size(), complete_length - header.size()));
+	for (auto line = std::string{}; std::getline(lines, line);) {
+		auto entry = journal_entry{};
+		auto result = int{0};
+		if (std::sscanf(line.c_str(), "%zu %d %lu", &entry.index, &result, &entry.solve_time_ns) !=
+			3) {
+			spdlog::error("Malformed journal record \"{}\" in {}", line, path.string());
+			return std::nullopt;
+		}
+		entry.result = satisfiability(result);
+		entries.push_back(entry);
+	}
+	return std::pair{complete_length, std::move(entries)};
+}
+} // namespace __internal
+
+journal::journal(int fd, journal_options options, std::vector<journal_entry> const& entries)
+	: m_fd{fd}, m_options{options}, m_last_sync{std::chrono::steady_clock::now()} {
+	for (auto const& entry : entries) {
+		m_entries[entry.index] = entry;
+	}
+}
+
+journal::~journal() {
+	flush();
+	close(m_fd);
+}
+
+auto journal::open(
+	std::filesystem::path const& path, std::string const& parameters, journal_options options)
+	-> std::unique_ptr<journal> {
+	if (path.has_parent_path() && !std::filesystem::is_directory(path.parent_path()) &&
+		!std::filesystem::create_directories(path.parent_path())) {
+		spdlog::error("Failed to create journal directory");
+		return nullptr;
+	}
+
+	const auto exists = std::filesystem::exists(path);
+	auto entries = std::vector<journal_entry>{};
+	auto complete_length = size_t{0};
+	if (exists) {
+		auto maybe_contents = __internal::read_journal(path, parameters);
+		if (!maybe_contents.has_value()) {
+			return nullptr;
+		}
+		std::tie(complete_length, entries) = std::move(maybe_contents.value());
+	}
+
+	const auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (fd < 0) {
+		spdlog::error("Failed to open {}: {}", path.string(), strerror(errno));
+		return nullptr;
+	}
+	if (exists) {
+		// drop a record torn by a crash so appended records start on a fresh line
+		if (ftruncate(fd, complete_length) != 0) {
+			spdlog::error("Failed to truncate {}: {}", path.string(), strerror(errno));
+			::close(fd);
+			return nullptr;
+		}
+	}
+
+	auto result = std::unique_ptr<journal>(new journal(fd, options, entries));
+	if (!exists) {
+		result->m_buffer = __internal::journal_header(parameters);
+		result->flush();
+	}
+	return result;
+}
+
+auto journal::find(size_t index) const -> std::optional<journal_entry> {
+	auto lock = std::scoped_lock(m_mutex);
+	const auto it = m_entries.find(index);
+	if (it == m_entries.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+auto journal::size() const -> size_t {
+	auto lock = std::scoped_lock(m_mutex);
+	return m_entries.size();
+}
+
+auto journal::record(journal_entry const& entry) -> void {
+	auto lock = std::scoped_lock(m_mutex);
+	m_entries[entry.index] = entry;
+	fmt::format_to(
+		std::back_inserter(m_buffer), "{} {} {}\n", entry.index, int(entry.result),
+		entry.solve_time_ns);
+	++m_n_buffered;
+	if (m_n_buffered >= m_options.records_per_sync ||
+		std::chrono::steady_clock::now() - m_last_sync >= m_options.sync_interval) {
+		write_buffer();
+	}
+}
+
+auto journal::flush() -> void {
+	auto lock = std::scoped_lock(m_mutex);
+	write_buffer();
+}
+
+auto journal::write_buffer() -> void {
+	for (auto written = size_t(0); written < m_buffer.size();) {
+		const auto n = write(m_fd, m_buffer.data() + written, m_buffer.size() - written);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			spdlog::error("Failed to write journal: {}", strerror(errno));
+			return;
+		}
+		written += n;
+	}
+	if (!m_buffer.empty() && fsync(m_fd) != 0) {
+		spdlog::error("Failed to sync journal: {}", strerror(errno));
+	}
+	m_buffer.clear();
+	m_n_buffered = 0;
+	m_last_sync = std::chrono::steady_clock::now();
+}
+
+auto load_journal(std::filesystem::path const& path, std::string const& parameters)
+	-> std::optional<std::vector<journal_entry>> {
+	if (!std::filesystem::exists(path)) {
+		spdlog::error("Missing journal {}", path.string());
+		return std::nullopt;
+	}
+	auto maybe_contents = __internal::read_journal(path, parameters);
+	if (!maybe_contents.has_value()) {
+		return std::nullopt;
+	}
+	return std::move(maybe_contents->second);
+}
+} // namespace cspc
@@ -1,13 +1,38 @@
 #include "cspc/kissat.hpp"
 
 #include "cspc/data_structures.hpp"
+#include "cspc/metrics.hpp"
 #include "gautil/functional.hpp"
 #include <memory>
 #include <spdlog/spdlog.h>
 
 namespace cspc {
-auto kissat_is_satisfiable(sat const& sat) -> satisfiability {
-	auto solver = std::unique_ptr<kissat, void (*)(kissat*)>(kissat_init(), kissat_release);
+namespace __internal {
+using kissat_ptr = std::unique_ptr<kissat, void (*)(kissat*)>;
+
+const auto DEFAULT_KISSAT_OPTIONS = kissat_options{};
+
+auto kissat_create(kissat_options const& options) -> kissat_ptr {
+	auto solver = kissat_ptr(kissat_init(), kissat_release);
+	if (!options.configuration.empty()) {
+		kissat_set_configuration(solver.get(), options.configuration.c_str());
+	}
+	for (auto const& [name, value] : options.options) {
+		kissat_set_option(solver.get(), name.c_str(), value);
+	}
+	return solver;
+}
+
+auto kissat_validate(kissat_options const& options) -> void {
+	if (!options.configuration.empty() && !kissat_has_configuration(options.configuration.c_str())) {
+		spdlog::critical("Unknown kissat configuration {}", options.configuration);
+		exit(EXIT_FAILURE);
+	}
+}
+
+auto kissat_load(sat const& sat, kissat_options const& options = DEFAULT_KISSAT_OPTIONS)
+	-> kissat_ptr {
+	auto solver = kissat_create(options);
 	const auto n_literals = gautil::fold(sat.clauses(), int(0), std::plus{}, &clause::size);
 	kissat_reserve(solver.get(), n_literals);
 	for (auto const& clause : sat.clauses()) {
@@ -16,15 +41,123 @@ auto kissat_is_satisfiable(sat const& sat) -> satisfiability {
 		}
 		kissat_add(solver.get(), 0); // clauses are terminated with a 0
 	}
-	const auto result = kissat_solve(solver.get());
+	return solver;
+}
+
+auto kissat_load_flat(
+	flat_clauses clauses, kissat_options const& options = DEFAULT_KISSAT_OPTIONS) -> kissat_ptr {
+	auto solver = kissat_create(options);
+	kissat_reserve(solver.get(), int(clauses.size()));
+	for (auto const lit : clauses) {
+		kissat_add(solver.get(), lit);
+	}
+	return solver;
+}
+
+auto kissat_solve_loaded(kissat* solver) -> satisfiability {
+	static auto& solve_time = global_metrics().histogram(
+		"cspc_kissat_solve_seconds", "Time taken by kissat to solve a loaded instance",
+		METRIC_SECONDS);
+	static auto& n_satisfiable = global_metrics().counter(
+		"cspc_kissat_results_total", "Instances solved by kissat", {{"result", "satisfiable"}});
+	static auto& n_unsatisfiable = global_metrics().counter(
+		"cspc_kissat_results_total", "Instances solved by kissat", {{"result", "unsatisfiable"}});
+	const auto result = [&]() {
+		const auto timer = scoped_timer(solve_time);
+		return kissat_solve(solver);
+	}();
 	switch (result) {
 	case 10:
+		n_satisfiable.add();
 		return SATISFIABLE;
 	case 20:
+		n_unsatisfiable.add();
 		return UNSATISFIABLE;
 	default:
 		spdlog::critical("Unhandled kissat response");
 		exit(EXIT_FAILURE);
 	}
 }
-} // namespace cspc
\ No newline at end of file
+
+auto kissat_find_model_loaded(kissat* solver, sat const& sat) -> std::optional<assignment> {
+	if (kissat_solve_loaded(solver) == UNSATISFIABLE) {
+		return std::nullopt;
+	}
+	const auto n_variables = gautil::fold(
+		sat.clauses(), u32(0), [](u32 lhs, u32 rhs) { return std::max(lhs, rhs); },
+		[](clause const& _clause) {
+			return gautil::fold(
+				_clause, u32(0), [](u32 lhs, u32 rhs) { return std::max(lhs, rhs); },
+				&literal::variable);
+		});
+	auto result = assignment(n_variables);
+	for (auto v = u32(0); v < n_variables; ++v) {
+		// kissat reports the literal if it is true and its negation otherwise
+		result[v] = kissat_value(solver, int(v + 1)) > 0;
+	}
+	return result;
+}
+} // namespace __internal
+
+auto kissat_is_satisfiable(sat const& sat) -> satisfiability {
+	const auto solver = __internal::kissat_load(sat);
+	return __internal::kissat_solve_loaded(solver.get());
+}
+
+auto kissat_is_satisfiable_flat(flat_clauses clauses) -> satisfiability {
+	const auto solver = __internal::kissat_load_flat(clauses);
+	return __internal::kissat_solve_loaded(solver.get());
+}
+
+auto kissat_find_model(sat const& sat) -> std::optional<assignment> {
+	const auto solver = __internal::kissat_load(sat);
+	return __internal::kissat_find_model_loaded(solver.get(), sat);
+}
+
+auto kissat_presets() -> std::vector<kissat_preset> const& {
+	static const auto presets = std::vector<kissat_preset>{
+		{"default", {}},
+		{"plain", {.configuration = "plain", .options = {}}},
+		{"sat", {.configuration = "sat", .options = {}}},
+		{"unsat", {.configuration = "unsat", .options = {}}},
+		{"no_eliminate", {.configuration = "", .options = {{"eliminate", 0}}}},
+		{"no_probe", {.configuration = "", .options = {{"probe", 0}}}},
+		{"no_simplify", {.configuration = "", .options = {{"eliminate", 0}, {"probe", 0}}}},
+		{"unsat_no_eliminate", {.configuration = "unsat", .options = {{"eliminate", 0}}}},
+		{"sat_no_probe", {.configuration = "sat", .options = {{"probe", 0}}}},
+	};
+	return presets;
+}
+
+auto find_kissat_preset(std::string const& name) -> std::optional<kissat_options> {
+	const auto it = std::ranges::find(kissat_presets(), name, &kissat_preset::name);
+	if (it == kissat_presets().end()) {
+		return std::nullopt;
+	}
+	return it->options;
+}
+
+auto create_kissat_solver(kissat_options const& options) -> solver {
+	__internal::kissat_validate(options);
+	return [options](sat const& sat) {
+		const auto solver = __internal::kissat_load(sat, options);
+		return __internal::kissat_solve_loaded(solver.get());
+	};
+}
+
+auto create_kissat_model_solver(kissat_options const& options) -> model_solver {
+	__internal::kissat_validate(options);
+	return [options](sat const& sat) {
+		const auto solver = __internal::kissat_load(sat, options);
+		return __internal::kissat_find_model_loaded(solver.get(), sat);
+	};
+}
+
+auto create_kissat_flat_solver(kissat_options const& options) -> flat_solver {
+	__internal::kissat_validate(options);
+	return [options](flat_clauses clauses) {
+		const auto solver = __internal::kissat_load_flat(clauses, options);
+		return __internal::kissat_solve_loaded(solver.get());
+	};
+}
+} // namespace cspc
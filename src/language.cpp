@@ -0,0 +1,82 @@
+#include "cspc/language.hpp"
+
+#include "cspc/algorithms.hpp"
+#include "cspc/metrics.hpp"
+#include <cmath>
+
+namespace cspc {
+language_meta_csp::language_meta_csp(
+	operation const& _operation, size_t domain_size, encoding _encoding)
+	: m_operation_arity{_operation.arity}, m_domain_size{domain_size},
+	  m_encoding{std::move(_encoding)},
+	  m_n_variables{(size_t)std::pow(domain_size, _operation.arity) + domain_size},
+	  m_variable_clauses{m_encoding(csp({}, m_n_variables, domain_size)).clauses()},
+	  m_max_variable{m_n_variables * domain_size} {
+	std::ranges::sort(m_variable_clauses, __internal::clause_less{});
+	const auto identity_constraints =
+		__internal::construct_operation_identity_constraints(_operation, domain_size);
+	__internal::append_encoded(
+		m_clauses, m_max_variable,
+		m_encoding(csp(identity_constraints, m_n_variables, domain_size)),
+		variable(m_n_variables * domain_size));
+}
+
+auto language_meta_csp::insert(relation const& _relation) -> void {
+	static auto& encoded_relations = global_metrics().counter(
+		"cspc_language_encoded_relations_total",
+		"Relations whose polymorphism constraints were added to a language meta-CSP");
+	if (!m_relations.insert(_relation).second) {
+		return;
+	}
+	m_language.push_back(_relation);
+	encoded_relations.add(1);
+
+	const auto polymorphism_constraints = __internal::construct_is_polymorphism_constraints(
+		_relation, m_domain_size, m_operation_arity);
+	__internal::append_encoded(
+		m_clauses, m_max_variable,
+		m_encoding(csp(polymorphism_constraints, m_n_variables, m_domain_size)),
+		variable(m_n_variables * m_domain_size), m_variable_clauses);
+}
+
+auto create_language_encoding_solver(
+	operation const& _operation, encoding _encoding, solver _solver) -> language_checker {
+	return create_language_encoding_solver(
+		_operation, 0, std::move(_encoding), std::move(_solver));
+}
+
+auto create_language_encoding_solver(
+	operation const& _operation, size_t min_domain_size, encoding _encoding, solver _solver)
+	-> language_checker {
+	struct state {
+		std::mutex mutex;
+		std::unique_ptr<language_meta_csp> meta_csp;
+	};
+	const auto _state = std::make_shared<state>();
+	return [_operation, min_domain_size, _encoding, _solver, _state](
+			   constraint_language const& language) {
+		const auto domain_size =
+			std::max(min_domain_size, __internal::find_language_domain_size(language));
+		const auto relations = std::unordered_set<relation>(language.begin(), language.end());
+
+		const auto encoded = [&]() {
+			const auto lock = std::scoped_lock(_state->mutex);
+			const auto extends_previous =
+				_state->meta_csp != nullptr && _state->meta_csp->domain_size() == domain_size &&
+				std::ranges::all_of(_state->meta_csp->language(), [&](relation const& _relation) {
+					return relations.contains(_relation);
+				});
+			if (!extends_previous) {
+				_state->meta_csp =
+					std::make_unique<language_meta_csp>(_operation, domain_size, _encoding);
+			}
+			for (auto const& _relation : language) {
+				_state->meta_csp->insert(_relation);
+			}
+			return _state->meta_csp->encoded();
+		}();
+		// solved outside the lock, so that concurrent checks only wait for each other's encoding
+		return _solver(encoded);
+	};
+}
+} // namespace cspc
@@ -0,0 +1,128 @@
+#include "cspc/lattice.hpp"
+
+#include "cspc/metrics.hpp"
+#include <bit>
+#include <cassert>
+
+namespace cspc {
+auto sublanguage(constraint_language const& pool, u64 subset) -> constraint_language {
+	auto language = constraint_language{};
+	language.reserve(std::popcount(subset));
+	for (auto i = size_t(0); i < pool.size(); ++i) {
+		if ((subset >> i) & 1) {
+			language.push_back(pool[i]);
+		}
+	}
+	return language;
+}
+
+auto symmetric_chains(size_t n) -> std::vector<std::vector<u64>> {
+	// reading bit i as the i:th bracket, 0 as an opening and 1 as a closing one, the subsets of a
+	// chain share their matched brackets, and going up the chain closes the leftmost unmatched
+	// opening bracket; a chain starts at the subset without unmatched closing brackets
+	auto chains = std::vector<std::vector<u64>>{};
+	for (auto subset = u64(0); subset < (u64(1) << n); ++subset) {
+		auto open = std::vector<size_t>{};
+		auto has_unmatched_closing = false;
+		for (auto i = size_t(0); i < n && !has_unmatched_closing; ++i) {
+			if (((subset >> i) & 1) == 0) {
+				open.push_back(i);
+			} else if (!open.empty()) {
+				open.pop_back();
+			} else {
+				has_unmatched_closing = true;
+			}
+		}
+		if (has_unmatched_closing) {
+			continue;
+		}
+		auto chain = std::vector<u64>{subset};
+		for (const auto i : open) {
+			chain.push_back(chain.back() | (u64(1) << i));
+		}
+		chains.push_back(std::move(chain));
+	}
+	// the longest chains cross the middle ranks, where a result decides the most subsets
+	std::ranges::stable_sort(chains, std::ranges::greater{}, &std::vector<u64>::size);
+	return chains;
+}
+
+namespace __internal {
+// records a solved subset and infers everything below (satisfiable) or above (unsatisfiable) it,
+// stopping at subsets already decided, whose own subsets or supersets are then decided too;
+// returns the number inferred
+auto decide_monotone(
+	std::vector<std::optional<lattice_result>>& results,
+	size_t n,
+	u64 subset,
+	satisfiability result) -> size_t {
+	auto n_inferred = size_t(0);
+	auto pending = std::vector<u64>{subset};
+	results[subset] = lattice_result{result, false};
+	while (!pending.empty()) {
+		const auto current = pending.back();
+		pending.pop_back();
+		for (auto i = size_t(0); i < n; ++i) {
+			const auto in_subset = ((current >> i) & 1) != 0;
+			if (in_subset != (result == SATISFIABLE)) {
+				continue;
+			}
+			const auto next = current ^ (u64(1) << i);
+			if (!results[next].has_value()) {
+				results[next] = lattice_result{result, true};
+				pending.push_back(next);
+				++n_inferred;
+			}
+		}
+	}
+	return n_inferred;
+}
+} // namespace __internal
+
+auto sweep_language_lattice(constraint_language const& pool, language_checker const& checker)
+	-> lattice_sweep {
+	static auto& n_solved_metric = global_metrics().counter(
+		"cspc_lattice_solved_total", "Languages of a lattice sweep solved with a checker");
+	static auto& n_inferred_metric = global_metrics().counter(
+		"cspc_lattice_inferred_total",
+		"Languages of a lattice sweep decided from a sublanguage or a superlanguage");
+	assert(pool.size() <= MAX_LATTICE_POOL_SIZE);
+
+	const auto n = pool.size();
+	auto results = std::vector<std::optional<lattice_result>>(size_t(1) << n);
+	auto sweep = lattice_sweep{.results = {}, .n_solved = 0, .n_inferred = 0};
+	for (auto const& chain : symmetric_chains(n)) {
+		// satisfiable subsets form a prefix of the chain, so the undecided ones are contiguous
+		auto low = size_t(0);
+		auto high = chain.size();
+		while (low < high && results[chain[low]].has_value() &&
+			   results[chain[low]]->result == SATISFIABLE) {
+			++low;
+		}
+		while (high > low && results[chain[high - 1]].has_value() &&
+			   results[chain[high - 1]]->result == UNSATISFIABLE) {
+			--high;
+		}
+		while (low < high) {
+			const auto middle = low + (high - low) / 2;
+			const auto result = checker(sublanguage(pool, chain[middle]));
+			++sweep.n_solved;
+			sweep.n_inferred += __internal::decide_monotone(results, n, chain[middle], result);
+			if (result == SATISFIABLE) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+	}
+
+	sweep.results.reserve(results.size());
+	for (auto const& result : results) {
+		assert(result.has_value());
+		sweep.results.push_back(result.value());
+	}
+	n_solved_metric.add(sweep.n_solved);
+	n_inferred_metric.add(sweep.n_inferred);
+	return sweep;
+}
+} // namespace cspc
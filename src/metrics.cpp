@@ -0,0 +1,246 @@
+#include "cspc/metrics.hpp"
+
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <gautil/system.hpp>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace cspc {
+namespace __internal {
+auto format_metric_labels(metric_labels const& labels) -> std::string {
+	auto result = std::string{};
+	for (auto const& [name, value] : labels) {
+		if (!result.empty()) {
+			result += ',';
+		}
+		result += name;
+		result += "=\"";
+		for (const auto c : value) {
+			switch (c) {
+			case '\\':
+				result += "\\\\";
+				break;
+			case '"':
+				result += "\\\"";
+				break;
+			case '\n':
+				result += "\\n";
+				break;
+			default:
+				result += c;
+			}
+		}
+		result += '"';
+	}
+	return result;
+}
+
+auto with_braces(std::string const& labels) -> std::string {
+	return labels.empty() ? labels : fmt::format("{{{}}}", labels);
+}
+
+template <typename Metric, typename... Args>
+auto find_or_create(
+	std::map<std::string, metric_family<Metric>>& families,
+	std::string const& name,
+	std::string const& help,
+	metric_labels const& labels,
+	Args&&... args) -> Metric& {
+	auto& family = families[name];
+	if (family.help.empty()) {
+		family.help = help;
+	}
+	auto& metric = family.series[format_metric_labels(labels)];
+	if (!metric) {
+		metric = std::make_unique<Metric>(std::forward<Args>(args)...);
+	}
+	return *metric;
+}
+
+auto append_histogram(
+	std::string& text, std::string const& name, std::string const& labels,
+	metric_histogram const& histogram) -> void {
+	auto counts = std::array<u64, gautil::N_LOG_LINEAR_BUCKETS>{};
+	auto last_used = size_t(0);
+	for (auto b = size_t(0); b < counts.size(); ++b) {
+		counts[b] = histogram.bucket(b);
+		if (counts[b] > 0) {
+			last_used = b;
+		}
+	}
+	const auto separator = labels.empty() ? "" : ",";
+	// cumulative counts at every power of two up to the largest recorded value; a bucket never
+	// straddles a power of two, so every bound is exact
+	const auto max_value = gautil::log_linear_bucket_value(last_used);
+	auto n_values = u64{0};
+	auto b = size_t(0);
+	for (auto bound = u64(1); bound != 0; bound <<= 1) {
+		for (; b < counts.size() && gautil::log_linear_bucket_value(b) < bound; ++b) {
+			n_values += counts[b];
+		}
+		text += fmt::format(
+			"{}_bucket{{{}{}le=\"{:.15g}\"}} {}\n", name, labels, separator,
+			f64(bound - 1) * histogram.unit(), n_values);
+		if (bound > max_value) {
+			break;
+		}
+	}
+	for (; b < counts.size(); ++b) {
+		n_values += counts[b];
+	}
+	text += fmt::format("{}_bucket{{{}{}le=\"+Inf\"}} {}\n", name, labels, separator, n_values);
+	text += fmt::format(
+		"{}_sum{} {:.15g}\n", name, with_braces(labels), f64(histogram.sum()) * histogram.unit());
+	text += fmt::format("{}_count{} {}\n", name, with_braces(labels), n_values);
+}
+} // namespace __internal
+
+auto metric_histogram::record(u64 value) -> void {
+	m_buckets[gautil::log_linear_bucket(value)].fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+auto metric_histogram::record(std::chrono::nanoseconds duration) -> void {
+	record(u64(std::max(duration.count(), i64(0))));
+}
+
+auto metrics_registry::counter(
+	std::string const& name, std::string const& help, metric_labels const& labels)
+	-> metric_counter& {
+	const auto lock = std::scoped_lock(m_mutex);
+	return __internal::find_or_create(m_counters, name, help, labels);
+}
+
+auto metrics_registry::gauge(
+	std::string const& name, std::string const& help, metric_labels const& labels)
+	-> metric_gauge& {
+	const auto lock = std::scoped_lock(m_mutex);
+	return __internal::find_or_create(m_gauges, name, help, labels);
+}
+
+auto metrics_registry::histogram(
+	std::string const& name, std::string const& help, f64 unit, metric_labels const& labels)
+	-> metric_histogram& {
+	const auto lock = std::scoped_lock(m_mutex);
+	return __internal::find_or_create(m_histograms, name, help, labels, unit);
+}
+
+auto metrics_registry::prometheus_text() const -> std::string {
+	const auto lock = std::scoped_lock(m_mutex);
+	auto text = std::string{};
+	for (auto const& [name, family] : m_counters) {
+		text += fmt::format("# HELP {} {}\n# TYPE {} counter\n", name, family.help, name);
+		for (auto const& [labels, counter] : family.series) {
+			text += fmt::format("{}{} {}\n", name, __internal::with_braces(labels), counter->value());
+		}
+	}
+	for (auto const& [name, family] : m_gauges) {
+		text += fmt::format("# HELP {} {}\n# TYPE {} gauge\n", name, family.help, name);
+		for (auto const& [labels, gauge] : family.series) {
+			text += fmt::format("{}{} {}\n", name, __internal::with_braces(labels), gauge->value());
+		}
+	}
+	for (auto const& [name, family] : m_histograms) {
+		text += fmt::format("# HELP {} {}\n# TYPE {} histogram\n", name, family.help, name);
+		for (auto const& [labels, histogram] : family.series) {
+			__internal::append_histogram(text, name, labels, *histogram);
+		}
+	}
+	return text;
+}
+
+auto global_metrics() -> metrics_registry& {
+	static auto registry = metrics_registry{};
+	return registry;
+}
+
+auto write_metrics(metrics_registry const& registry, std::filesystem::path const& path) -> bool {
+	auto temporary = path;
+	temporary += ".tmp";
+	{
+		auto ofs = std::ofstream(temporary, std::ios::trunc);
+		ofs << registry.prometheus_text();
+		if (!ofs) {
+			spdlog::error("Failed to write metrics to {}", temporary.string());
+			return false;
+		}
+	}
+	auto error = std::error_code{};
+	std::filesystem::rename(temporary, path, error);
+	if (error) {
+		spdlog::error("Failed to replace {}: {}", path.string(), error.message());
+		return false;
+	}
+	return true;
+}
+
+metrics_file_exporter::metrics_file_exporter(
+	metrics_registry const& registry, std::filesystem::path path,
+	std::chrono::milliseconds interval)
+	: m_registry{registry}, m_path{std::move(path)}, m_interval{interval} {
+	m_export_thread = std::jthread([this](std::stop_token stop) { export_loop(stop); });
+}
+
+metrics_file_exporter::~metrics_file_exporter() {
+	m_export_thread.request_stop();
+	m_export_thread.join();
+	write_metrics(m_registry, m_path);
+}
+
+auto metrics_file_exporter::export_loop(std::stop_token stop) -> void {
+	auto lock = std::unique_lock(m_mutex);
+	// sleeps for the interval but wakes immediately when the exporter is destroyed
+	const auto stopped = [&] { return stop.stop_requested(); };
+	while (!m_wake.wait_for(lock, stop, m_interval, stopped)) {
+		write_metrics(m_registry, m_path);
+	}
+}
+
+metrics_socket_exporter::~metrics_socket_exporter() { stop(); }
+
+auto metrics_socket_exporter::listen(std::filesystem::path const& path) -> bool {
+	const auto fd = gautil::listen_unix_socket(path);
+	if (!fd.has_value()) {
+		return false;
+	}
+	m_path = path;
+	m_listen_fd = fd.value();
+	m_acceptor = std::jthread([this](std::stop_token stop) { accept_loop(stop); });
+	return true;
+}
+
+auto metrics_socket_exporter::stop() -> void {
+	if (m_listen_fd < 0) {
+		return;
+	}
+	m_acceptor.request_stop();
+	::shutdown(m_listen_fd, SHUT_RDWR);
+	m_acceptor.join();
+	::close(m_listen_fd);
+	m_listen_fd = -1;
+	auto error = std::error_code{};
+	std::filesystem::remove(m_path, error);
+}
+
+auto metrics_socket_exporter::accept_loop(std::stop_token stop) -> void {
+	while (!stop.stop_requested()) {
+		const auto fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			if (!stop.stop_requested()) {
+				spdlog::error("Failed to accept a connection: {}", strerror(errno));
+			}
+			return;
+		}
+		// a dump is small, so it is written inline rather than on a thread per connection
+		const auto text = m_registry.prometheus_text();
+		gautil::send_all(fd, text.data(), text.size());
+		::close(fd);
+	}
+}
+} // namespace cspc
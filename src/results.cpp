@@ -0,0 +1,249 @@
+#include "cspc/results.hpp"
+
+#include "cspc/algorithms.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <gautil/math.hpp>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cspc {
+namespace __internal {
+constexpr auto RESULTS_MAGIC = std::string_view("CSPCRES1");
+constexpr auto RESULTS_VERSION = u32{1};
+constexpr auto RESULTS_HEADER_SIZE = size_t{64};
+
+struct results_header {
+	char magic[8];
+	u32 version;
+	u32 zero;
+	u64 n_relations;
+};
+static_assert(sizeof(results_header) <= RESULTS_HEADER_SIZE);
+static_assert(std::endian::native == std::endian::little, "result stores are little endian");
+
+struct results_layout {
+	size_t classes;
+	size_t solve_times;
+	size_t n_clauses;
+	size_t fast_path_rules;
+	size_t file_size;
+};
+
+auto compute_results_layout(size_t n_relations) -> results_layout {
+	const auto n_class_words = (n_relations + 31) / 32;
+	auto layout = results_layout{};
+	layout.classes = RESULTS_HEADER_SIZE;
+	layout.solve_times = layout.classes + n_class_words * sizeof(u64);
+	layout.n_clauses = layout.solve_times + n_relations * sizeof(u64);
+	layout.fast_path_rules = layout.n_clauses + n_relations * sizeof(u64);
+	layout.file_size = layout.fast_path_rules + (n_relations + 7) / 8 * 8;
+	return layout;
+}
+
+auto map_results(std::filesystem::path const& path, int flags, size_t expected_size = 0)
+	-> std::pair<void*, size_t> {
+	const auto writable = (flags & O_ACCMODE) == O_RDWR;
+	const auto fd = ::open(path.c_str(), flags, 0644);
+	if (fd < 0) {
+		spdlog::error("Failed to open {}: {}", path.string(), strerror(errno));
+		return {nullptr, 0};
+	}
+	if (expected_size > 0 && ftruncate(fd, expected_size) != 0) {
+		spdlog::error("Failed to resize {}: {}", path.string(), strerror(errno));
+		::close(fd);
+		return {nullptr, 0};
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 || size_t(status.st_size) < RESULTS_HEADER_SIZE) {
+		spdlog::error("{} is not a result store", path.string());
+		::close(fd);
+		return {nullptr, 0};
+	}
+	const auto size = size_t(status.st_size);
+	auto* mapping =
+		mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		spdlog::error("Failed to map {}: {}", path.string(), strerror(errno));
+		return {nullptr, 0};
+	}
+	return {mapping, size};
+}
+} // namespace __internal
+
+auto to_relation_class(satisfiability result) -> relation_class {
+	// by the dichotomy theorem, a siggers polymorphism makes the csp tractable and its absence
+	// makes it NP-hard
+	return result == SATISFIABLE ? POLYNOMIAL : NP_HARD;
+}
+
+result_store::result_store(void* mapping, size_t mapping_size, size_t n_relations)
+	: m_mapping{mapping}, m_mapping_size{mapping_size}, m_n_relations{n_relations} {
+	const auto layout = __internal::compute_results_layout(n_relations);
+	auto* bytes = static_cast<char*>(mapping);
+	m_classes = reinterpret_cast<u64*>(bytes + layout.classes);
+	m_solve_times = reinterpret_cast<u64*>(bytes + layout.solve_times);
+	m_n_clauses = reinterpret_cast<u64*>(bytes + layout.n_clauses);
+	m_fast_path_rules = reinterpret_cast<u8*>(bytes + layout.fast_path_rules);
+}
+
+result_store::~result_store() { munmap(m_mapping, m_mapping_size); }
+
+auto result_store::create(std::filesystem::path const& path, size_t n_relations)
+	-> std::unique_ptr<result_store> {
+	const auto layout = __internal::compute_results_layout(n_relations);
+	// truncating first zeroes every column, which makes every record unknown
+	const auto [mapping, size] =
+		__internal::map_results(path, O_RDWR | O_CREAT | O_TRUNC, layout.file_size);
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	auto header = __internal::results_header{
+		.magic = {},
+		.version = __internal::RESULTS_VERSION,
+		.zero = 0,
+		.n_relations = n_relations,
+	};
+	std::ranges::copy(__internal::RESULTS_MAGIC, header.magic);
+	std::memcpy(mapping, &header, sizeof(header));
+	return std::unique_ptr<result_store>(new result_store(mapping, size, n_relations));
+}
+
+auto result_store::open(std::filesystem::path const& path, bool writable)
+	-> std::unique_ptr<result_store> {
+	const auto [mapping, size] = __internal::map_results(path, writable ? O_RDWR : O_RDONLY);
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	auto header = __internal::results_header{};
+	std::memcpy(&header, mapping, sizeof(header));
+	if (std::string_view(header.magic, sizeof(header.magic)) != __internal::RESULTS_MAGIC ||
+		header.version != __internal::RESULTS_VERSION ||
+		header.n_relations > size / sizeof(u64) ||
+		__internal::compute_results_layout(header.n_relations).file_size != size) {
+		spdlog::error(
+			"{} is not a version {} result store", path.string(), __internal::RESULTS_VERSION);
+		munmap(mapping, size);
+		return nullptr;
+	}
+	return std::unique_ptr<result_store>(new result_store(mapping, size, header.n_relations));
+}
+
+auto result_store::classification(size_t index) const -> relation_class {
+	const auto word = std::atomic_ref(m_classes[index / 32]).load(std::memory_order_relaxed);
+	return relation_class((word >> (index % 32 * 2)) & 3);
+}
+
+auto result_store::get(size_t index) const -> result_record {
+	const auto rule = m_fast_path_rules[index];
+	return result_record{
+		.classification = classification(index),
+		.solve_time_ns = m_solve_times[index],
+		.n_clauses = m_n_clauses[index],
+		.fast_path_rule = rule == 0 ? std::nullopt : std::optional{size_t(rule - 1)},
+	};
+}
+
+auto result_store::set(size_t index, result_record const& record) -> void {
+	m_solve_times[index] = record.solve_time_ns;
+	m_n_clauses[index] = record.n_clauses;
+	m_fast_path_rules[index] =
+		record.fast_path_rule.has_value() ? u8(record.fast_path_rule.value() + 1) : 0;
+
+	// neighboring relations share a word of the class column
+	const auto shift = index % 32 * 2;
+	auto word = std::atomic_ref(m_classes[index / 32]);
+	auto expected = word.load(std::memory_order_relaxed);
+	while (!word.compare_exchange_weak(
+		expected, (expected & ~(u64(3) << shift)) | (u64(record.classification) << shift),
+		std::memory_order_relaxed)) {
+	}
+}
+
+auto summarize_results(result_store const& store, size_t first, size_t last) -> result_summary {
+	auto summary = result_summary{
+		.class_counts = {},
+		.fast_path_counts = {},
+		.total_solve_time_ns = 0,
+		.total_clauses = 0,
+		.solve_time_p50_ns = 0,
+		.solve_time_p90_ns = 0,
+		.solve_time_p99_ns = 0,
+		.solve_time_max_ns = 0,
+	};
+	auto histogram = std::array<u64, gautil::N_LOG_LINEAR_BUCKETS>{};
+	auto n_recorded = u64{0};
+	for (auto i = first; i < std::min(last, store.size()); ++i) {
+		const auto record = store.get(i);
+		++summary.class_counts[record.classification];
+		if (record.classification == UNKNOWN_CLASS) {
+			continue;
+		}
+		if (record.fast_path_rule.has_value()) {
+			const auto rule = record.fast_path_rule.value();
+			summary.fast_path_counts.resize(std::max(summary.fast_path_counts.size(), rule + 1));
+			++summary.fast_path_counts[rule];
+		}
+		summary.total_solve_time_ns += record.solve_time_ns;
+		summary.total_clauses += record.n_clauses;
+		summary.solve_time_max_ns = std::max(summary.solve_time_max_ns, record.solve_time_ns);
+		++histogram[gautil::log_linear_bucket(record.solve_time_ns)];
+		++n_recorded;
+	}
+
+	const auto quantile = [&](f64 q) {
+		const auto target = std::max(u64(std::ceil(q * f64(n_recorded))), u64(1));
+		auto seen = u64{0};
+		for (auto b = size_t(0); b < histogram.size(); ++b) {
+			seen += histogram[b];
+			if (seen >= target) {
+				return gautil::log_linear_bucket_value(b);
+			}
+		}
+		return u64{0};
+	};
+	summary.solve_time_p50_ns = quantile(0.5);
+	summary.solve_time_p90_ns = quantile(0.9);
+	summary.solve_time_p99_ns = quantile(0.99);
+	return summary;
+}
+
+auto create_recording_checker(
+	std::vector<fast_path_rule> rules,
+	encoding _encoding,
+	solver _solver,
+	std::shared_ptr<result_store> store) -> std::function<satisfiability(size_t, relation const&)> {
+	return [_operation = siggers_operation(), rules = std::move(rules), _encoding, _solver,
+			store](size_t index, relation const& _relation) {
+		const auto time_before = std::chrono::steady_clock::now();
+		auto record = result_record{
+			.classification = UNKNOWN_CLASS,
+			.solve_time_ns = 0,
+			.n_clauses = 0,
+			.fast_path_rule = std::nullopt,
+		};
+		auto result = UNSATISFIABLE;
+		const auto decision = classify_fast_path(_operation, _relation, rules);
+		if (decision.has_value()) {
+			result = decision->result;
+			record.fast_path_rule = decision->rule;
+		} else {
+			const auto sat = _encoding(construct_preserves_operation_csp(_operation, _relation));
+			record.n_clauses = sat.clauses().size();
+			result = _solver(sat);
+		}
+		record.classification = to_relation_class(result);
+		record.solve_time_ns = u64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+									   std::chrono::steady_clock::now() - time_before)
+									   .count());
+		store->set(index, record);
+		return result;
+	};
+}
+} // namespace cspc
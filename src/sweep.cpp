@@ -0,0 +1,156 @@
+#include "cspc/sweep.hpp"
+
+#include "cspc/journal.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <gautil/system.hpp>
+#include <map>
+#include <ranges>
+#include <spdlog/spdlog.h>
+
+namespace cspc {
+auto shard_range(size_t n_items, size_t shard_index, size_t n_shards) -> shard {
+	// the first n_items % n_shards shards take one extra item
+	const auto base = n_items / n_shards;
+	const auto remainder = n_items % n_shards;
+	const auto begin = shard_index * base + std::min(shard_index, remainder);
+	const auto end = begin + base + (shard_index < remainder ? 1 : 0);
+	return shard{.index = shard_index, .begin = begin, .end = end};
+}
+
+auto shard_result_path(std::filesystem::path const& directory, size_t shard_index)
+	-> std::filesystem::path {
+	return directory / fmt::format("shard_{}.txt", shard_index);
+}
+
+namespace __internal {
+auto shard_journal_parameters(shard const& _shard) -> std::string {
+	return fmt::format("shard {} [{}, {})", _shard.index, _shard.begin, _shard.end);
+}
+} // namespace __internal
+
+auto run_shard(
+	std::vector<relation> const& relations,
+	shard const& _shard,
+	polymorphism_checker const& checker,
+	std::filesystem::path const& directory) -> bool {
+	const auto path = shard_result_path(directory, _shard.index);
+	auto partial_path = path;
+	partial_path += ".part";
+
+	// a restarted worker resumes from the relations its predecessor journaled
+	auto _journal = journal::open(partial_path, __internal::shard_journal_parameters(_shard));
+	if (_journal == nullptr) {
+		return false;
+	}
+	for (auto i = _shard.begin; i < std::min(_shard.end, relations.size()); ++i) {
+		if (_journal->find(i).has_value()) {
+			continue;
+		}
+		const auto time_before = std::chrono::steady_clock::now();
+		const auto result = checker(relations[i]);
+		const auto time_after = std::chrono::steady_clock::now();
+		_journal->record(journal_entry{
+			.index = i,
+			.result = result,
+			.solve_time_ns = u64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+									 time_after - time_before)
+									 .count()),
+		});
+	}
+	_journal.reset();
+
+	// renaming is atomic, so a result file is never seen half written
+	auto error = std::error_code{};
+	std::filesystem::rename(partial_path, path, error);
+	if (error) {
+		spdlog::error("Failed to rename {}: {}", partial_path.string(), error.message());
+		return false;
+	}
+	return true;
+}
+
+auto supervise_shards(
+	size_t n_shards,
+	std::filesystem::path const& directory,
+	std::function<std::vector<std::string>(size_t shard_index)> const& worker_command,
+	supervisor_options const& options) -> bool {
+	auto pending = std::vector<size_t>{};
+	for (auto i = n_shards; i-- > 0;) {
+		if (!std::filesystem::exists(shard_result_path(directory, i))) {
+			pending.push_back(i);
+		}
+	}
+
+	auto running = std::map<pid_t, size_t>{};
+	auto restarts = std::vector<size_t>(n_shards);
+	auto failed = false;
+	while (!pending.empty() || !running.empty()) {
+		while (!pending.empty() && running.size() < options.n_workers) {
+			const auto shard_index = pending.back();
+			pending.pop_back();
+			const auto maybe_pid = gautil::spawn(worker_command(shard_index));
+			if (!maybe_pid.has_value()) {
+				spdlog::error("Failed to start worker for shard {}", shard_index);
+				failed = true;
+				continue;
+			}
+			running[maybe_pid.value()] = shard_index;
+		}
+
+		// only the workers are waited for, as the process may have other children, such as
+		// external solvers
+		auto running_pids = std::vector<pid_t>{};
+		std::ranges::copy(std::views::keys(running), std::back_inserter(running_pids));
+		const auto maybe_exit = gautil::wait_for_any_of(running_pids);
+		if (!maybe_exit.has_value()) {
+			break;
+		}
+		const auto it = running.find(maybe_exit->pid);
+		const auto shard_index = it->second;
+		running.erase(it);
+
+		if (maybe_exit->success && std::filesystem::exists(shard_result_path(directory, shard_index))) {
+			continue;
+		}
+		if (restarts[shard_index]++ < options.max_restarts) {
+			spdlog::warn(
+				"Worker for shard {} failed, restarting ({}/{})", shard_index,
+				restarts[shard_index], options.max_restarts);
+			pending.push_back(shard_index);
+		} else {
+			spdlog::error("Worker for shard {} failed too many times", shard_index);
+			failed = true;
+		}
+	}
+	return !failed;
+}
+
+auto merge_shard_results(std::filesystem::path const& directory, size_t n_shards, size_t n_items)
+	-> std::optional<std::vector<satisfiability>> {
+	auto results = std::vector<satisfiability>(n_items);
+	auto seen = std::vector<bool>(n_items);
+	for (auto i = size_t(0); i < n_shards; ++i) {
+		const auto maybe_entries = load_journal(
+			shard_result_path(directory, i),
+			__internal::shard_journal_parameters(shard_range(n_items, i, n_shards)));
+		if (!maybe_entries.has_value()) {
+			return std::nullopt;
+		}
+		for (auto const& entry : maybe_entries.value()) {
+			if (entry.index >= n_items || seen[entry.index]) {
+				spdlog::error("Unexpected relation index {} in shard {}", entry.index, i);
+				return std::nullopt;
+			}
+			results[entry.index] = entry.result;
+			seen[entry.index] = true;
+		}
+	}
+	if (std::ranges::find(seen, false) != seen.end()) {
+		spdlog::error("Shard results do not cover every relation");
+		return std::nullopt;
+	}
+	return results;
+}
+} // namespace cspc
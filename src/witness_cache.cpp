@@ -0,0 +1,134 @@
+#include "cspc/witness_cache.hpp"
+
+#include "cspc/algorithms.hpp"
+#include "cspc/metrics.hpp"
+#include <cmath>
+
+namespace cspc {
+auto preserves(function_table const& table, relation const& _relation) -> bool {
+	if (_relation.empty()) {
+		return true;
+	}
+	const auto domain_size = __internal::find_relation_domain_size(_relation);
+	if (domain_size > table.domain_size) {
+		return false;
+	}
+	const auto arity = _relation.arity();
+	const auto n_rows = _relation.size();
+
+	// membership of every tuple over the relation's domain, by mixed radix index
+	auto contains = std::vector<bool>((size_t)std::pow(domain_size, arity));
+	for (auto const& entry : _relation) {
+		contains[__internal::function_input_to_index(entry, domain_size)] = true;
+	}
+
+	// weights[k][i * arity + j] is what row i contributes to the table index of column j when it
+	// is the k:th argument of the operation
+	auto weights = std::vector<std::vector<size_t>>(table.arity);
+	auto multiplier = size_t(1);
+	for (auto k = table.arity; k-- > 0;) {
+		weights[k].resize(n_rows * arity);
+		for (auto i = size_t(0); i < n_rows; ++i) {
+			for (auto j = size_t(0); j < arity; ++j) {
+				weights[k][i * arity + j] = _relation[i][j] * multiplier;
+			}
+		}
+		multiplier *= table.domain_size;
+	}
+
+	// for each choice of rows, apply the operation column-wise and look up the image
+	auto rows = std::vector<size_t>(table.arity);
+	auto indices = std::vector<size_t>(arity);
+	const auto n_iterations = (size_t)std::pow(n_rows, table.arity);
+	for (auto iteration = size_t(0); iteration < n_iterations; ++iteration) {
+		std::ranges::fill(indices, 0);
+		for (auto k = size_t(0); k < table.arity; ++k) {
+			const auto* row_weights = &weights[k][rows[k] * arity];
+			for (auto j = size_t(0); j < arity; ++j) {
+				indices[j] += row_weights[j];
+			}
+		}
+		auto image = size_t(0);
+		for (auto j = size_t(0); j < arity; ++j) {
+			const auto value = table.values[indices[j]];
+			if (value >= domain_size) {
+				return false;
+			}
+			image = image * domain_size + value;
+		}
+		if (!contains[image]) {
+			return false;
+		}
+
+		for (auto& row : rows) {
+			if (++row < n_rows) {
+				break;
+			}
+			row = 0;
+		}
+	}
+	return true;
+}
+
+auto witness_cache::find(operation const& _operation, relation const& _relation)
+	-> std::optional<function_table> {
+	static auto& global_hits = global_metrics().counter(
+		"cspc_witness_cache_hits_total", "Relations preserved by a cached polymorphism");
+	static auto& global_misses = global_metrics().counter(
+		"cspc_witness_cache_misses_total", "Relations preserved by no cached polymorphism");
+	auto lock = std::scoped_lock(m_mutex);
+	const auto it = std::ranges::find_if(m_tables, [&](auto const& cached) {
+		return cached.first == _operation && preserves(cached.second, _relation);
+	});
+	if (it == m_tables.end()) {
+		m_misses.fetch_add(1, std::memory_order_relaxed);
+		global_misses.add();
+		return std::nullopt;
+	}
+	m_hits.fetch_add(1, std::memory_order_relaxed);
+	global_hits.add();
+	m_tables.splice(m_tables.begin(), m_tables, it);
+	return m_tables.front().second;
+}
+
+auto witness_cache::insert(operation const& _operation, function_table table) -> void {
+	auto lock = std::scoped_lock(m_mutex);
+	m_tables.emplace_front(_operation, std::move(table));
+	if (m_tables.size() > m_capacity) {
+		m_tables.pop_back();
+	}
+}
+
+auto create_witness_caching_solver(
+	operation const& _operation,
+	encoding _encoding,
+	decoder _decoder,
+	model_solver _solver,
+	std::shared_ptr<witness_cache> cache) -> polymorphism_checker {
+	return [_operation, _encoding, _decoder, _solver, cache](relation const& _relation) {
+		if (cache->find(_operation, _relation).has_value()) {
+			return SATISFIABLE;
+		}
+		const auto csp = construct_preserves_operation_csp(_operation, _relation);
+		const auto model = _solver(_encoding(csp));
+		if (!model.has_value()) {
+			return UNSATISFIABLE;
+		}
+
+		// the function table makes up the first csp variables
+		const auto values = _decoder(csp, model.value());
+		const auto n_entries = (size_t)std::pow(csp.domain_size(), _operation.arity);
+		auto table = function_table{
+			.arity = _operation.arity,
+			.domain_size = csp.domain_size(),
+			.values = std::vector<domain_value>(n_entries),
+		};
+		std::copy_n(values.begin(), std::min(n_entries, values.size()), table.values.begin());
+		// entries outside of every constraint are unconstrained and may decode out of domain
+		std::ranges::replace_if(
+			table.values, [&](auto value) { return value >= table.domain_size; }, 0);
+		cache->insert(_operation, std::move(table));
+		return SATISFIABLE;
+	};
+}
+} // namespace cspc
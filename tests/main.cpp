@@ -1,6 +1,21 @@
+#include "test_context.hpp"
+#include "test_core.hpp"
+#include "test_corpus.hpp"
+#include "test_daemon.hpp"
 #include "test_encodings.hpp"
+#include "test_external_solver.hpp"
+#include "test_language.hpp"
+#include "test_lattice.hpp"
+#include "test_fast_path.hpp"
+#include "test_incremental.hpp"
+#include "test_journal.hpp"
 #include "test_kissat.hpp"
+#include "test_metrics.hpp"
 #include "test_polymorphisms.hpp"
+#include "test_relation.hpp"
+#include "test_results.hpp"
+#include "test_sweep.hpp"
+#include "test_witness_cache.hpp"
 #include <algorithm>
 #include <numeric>
 #include <ranges>
@@ -25,6 +40,21 @@ auto main() -> int {
 		std::move(test_kissat),
 		std::move(test_polymorphisms),
 		std::move(test_encodings),
+		std::move(test_fast_path),
+		std::move(test_witness_cache),
+		std::move(test_sweep),
+		std::move(test_journal),
+		std::move(test_incremental),
+		std::move(test_context),
+		std::move(test_corpus),
+		std::move(test_results),
+		std::move(test_daemon),
+		std::move(test_metrics),
+		std::move(test_core),
+		std::move(test_language),
+		std::move(test_lattice),
+		std::move(test_relation),
+		std::move(test_external_solver),
 	};
 	spdlog::info("Running tests...");
 	auto results = std::vector<TestResult>{};
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// a stand-in for an external sat solver: reads DIMACS CNF from standard input and reports the
+// result like a competition solver, or misbehaves as asked by its one argument:
+//   --crash    aborts after reading the instance
+//   --hang     never answers
+//   --silent   only reports through its exit code
+//   --unknown  reports s UNKNOWN
+
+namespace {
+using clauses = std::vector<std::vector<int>>;
+
+// davis-putnam-logemann-loveland with unit propagation, values[v] is 0 while unassigned
+auto is_satisfiable(clauses const& cnf, std::vector<int> values) -> bool {
+	for (auto changed = true; changed;) {
+		changed = false;
+		for (auto const& clause : cnf) {
+			auto n_unassigned = 0;
+			auto last = 0;
+			auto satisfied = false;
+			for (const auto literal : clause) {
+				const auto value = values[std::abs(literal)];
+				if (value == 0) {
+					++n_unassigned;
+					last = literal;
+				} else if ((value > 0) == (literal > 0)) {
+					satisfied = true;
+					break;
+				}
+			}
+			if (satisfied) {
+				continue;
+			}
+			if (n_unassigned == 0) {
+				return false;
+			}
+			if (n_unassigned == 1) {
+				values[std::abs(last)] = last > 0 ? 1 : -1;
+				changed = true;
+			}
+		}
+	}
+	for (auto v = size_t(1); v < values.size(); ++v) {
+		if (values[v] != 0) {
+			continue;
+		}
+		for (const auto sign : {1, -1}) {
+			auto assigned = values;
+			assigned[v] = sign;
+			if (is_satisfiable(cnf, std::move(assigned))) {
+				return true;
+			}
+		}
+		return false;
+	}
+	return true;
+}
+} // namespace
+
+auto main(int argc, char* argv[]) -> int {
+	const auto mode = argc > 1 ? std::string(argv[1]) : std::string{};
+
+	auto cnf = clauses{};
+	auto n_variables = 0;
+	auto clause = std::vector<int>{};
+	for (auto line = std::string{}; std::getline(std::cin, line);) {
+		if (line.empty() || line[0] == 'c') {
+			continue;
+		}
+		auto stream = std::istringstream(line);
+		if (line[0] == 'p') {
+			auto p = std::string{};
+			auto format = std::string{};
+			auto n_clauses = 0;
+			stream >> p >> format >> n_variables >> n_clauses;
+			continue;
+		}
+		for (auto literal = 0; stream >> literal;) {
+			if (literal == 0) {
+				cnf.push_back(std::move(clause));
+				clause = {};
+			} else {
+				clause.push_back(literal);
+			}
+		}
+	}
+
+	if (mode == "--crash") {
+		std::abort();
+	}
+	if (mode == "--hang") {
+		while (true) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+	if (mode == "--unknown") {
+		std::cout << "s UNKNOWN" << std::endl;
+		return 0;
+	}
+	const auto satisfiable = is_satisfiable(cnf, std::vector<int>(n_variables + 1, 0));
+	if (mode != "--silent") {
+		std::cout << "c stand-in solver\n"
+				  << (satisfiable ? "s SATISFIABLE" : "s UNSATISFIABLE") << std::endl;
+	}
+	return satisfiable ? 10 : 20;
+}
@@ -0,0 +1,74 @@
+#include "test_context.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/context.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto flat(cspc::sat const& sat) -> std::vector<i32> {
+	auto result = std::vector<i32>{};
+	for (auto const& _clause : sat.clauses()) {
+		std::ranges::transform(_clause, std::back_inserter(result), &cspc::literal::value);
+		result.push_back(0);
+	}
+	return result;
+}
+
+const auto test_context_encoding = TestSingle{
+	"context encoding",
+	[]() {
+		// the polymorphism clauses match the direct encoding of a meta-CSP without identities
+		const auto projection = cspc::operation(2, {});
+		auto context = cspc::classification_context(projection, cspc::multivalued_direct_encoding);
+		const auto relation = cspc::relation{{0, 1}, {1, 0}};
+		const auto encoded = context.encode(relation);
+
+		const auto domain_size = 2;
+		const auto n_variables = 4 + domain_size;
+		const auto identities =
+			flat(cspc::multivalued_direct_encoding(cspc::csp({}, n_variables, domain_size)));
+		const auto polymorphism = flat(cspc::multivalued_direct_encoding(cspc::csp(
+			cspc::__internal::construct_is_polymorphism_constraints(relation, domain_size, 2),
+			n_variables, domain_size)));
+		auto expected = identities;
+		std::copy(
+			polymorphism.begin() + identities.size(), polymorphism.end(),
+			std::back_inserter(expected));
+		return test_eq(std::vector<i32>(encoded.begin(), encoded.end()), expected);
+	},
+};
+
+template <typename Encoding>
+auto test_context_solver(std::string const& name, Encoding encoding) -> TestSingle {
+	return TestSingle{
+		name,
+		[encoding]() {
+			const auto checker = cspc::create_encoding_solver(
+				cspc::siggers_operation(), encoding, cspc::kissat_is_satisfiable);
+			const auto context_checker = cspc::create_context_solver(
+				cspc::siggers_operation(), encoding, cspc::kissat_is_satisfiable_flat);
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto actual = std::vector<cspc::satisfiability>{};
+			for (auto const& relations :
+				 {cspc::all_nary_relations(2, 3), cspc::all_nary_relations(3, 2)}) {
+				std::ranges::transform(relations, std::back_inserter(expected), checker);
+				std::ranges::transform(relations, std::back_inserter(actual), context_checker);
+			}
+			return test_eq(actual, expected);
+		},
+	};
+}
+} // namespace
+
+const TestModule test_context = {
+	.description = "classification context tests",
+	.tests =
+		{
+			test_context_encoding,
+			test_context_solver("context solver direct encoding", cspc::direct_encoding),
+			test_context_solver(
+				"context solver multivalued direct encoding", cspc::multivalued_direct_encoding),
+		},
+};
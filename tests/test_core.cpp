@@ -0,0 +1,103 @@
+#include "test_core.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/core.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+const auto test_find_core = TestBundle{
+	"find core",
+	{
+		[]() {
+			return test_eq(
+				cspc::find_core(cspc::neq_relation(2, 3)).data(), cspc::neq_relation(2, 3).data());
+		},
+		[]() {
+			// a path retracts onto one of its edges
+			const auto path = cspc::relation{{0, 1}, {1, 0}, {1, 2}, {2, 1}};
+			return test_eq(cspc::find_core(path).data(), cspc::relation{{0, 1}, {1, 0}}.data());
+		},
+		[]() {
+			return test_eq(
+				cspc::find_core(cspc::eq_relation(2, 3)).data(), cspc::relation{{0, 0}}.data());
+		},
+		[]() {
+			// the unused value 1 is dropped and 2 is renumbered
+			const auto core = cspc::find_core(cspc::relation{{0, 2}, {2, 0}});
+			return test_eq(core.data(), cspc::relation{{0, 1}, {1, 0}}.data());
+		},
+	},
+};
+
+const auto test_core_cache = TestSingle{
+	"core cache",
+	[]() {
+		// a permuted relation hits, and the least recently used relation is evicted
+		auto cache = cspc::core_cache(2);
+		const auto path = cspc::relation{{0, 1}, {1, 0}, {1, 2}, {2, 1}};
+		const auto permuted_path = cspc::relation{{2, 1}, {1, 2}, {1, 0}, {0, 1}};
+		cache.find(path);
+		cache.find(cspc::neq_relation(2, 3));
+		cache.find(permuted_path);
+		cache.find(cspc::eq_relation(2, 3));
+		cache.find(path);
+		cache.find(cspc::neq_relation(2, 3));
+		return test_eq(
+			std::vector{cache.hits(), cache.misses()}, std::vector{size_t(2), size_t(4)});
+	},
+};
+
+const auto test_core_encoding_solver = TestSingle{
+	"core encoding solver",
+	[]() {
+		const auto checker = cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable);
+		const auto cache = std::make_shared<cspc::core_cache>(1024);
+		const auto core_checker = cspc::create_core_encoding_solver(
+			cspc::siggers_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable, cache);
+
+		auto expected = std::vector<cspc::satisfiability>{};
+		auto actual = std::vector<cspc::satisfiability>{};
+		for (auto const& relations :
+			 {cspc::all_nary_relations(2, 3), cspc::all_nary_relations(3, 2)}) {
+			std::ranges::transform(relations, std::back_inserter(expected), checker);
+			std::ranges::transform(relations, std::back_inserter(actual), core_checker);
+		}
+		return test_eq(actual, expected);
+	},
+};
+
+const auto test_core_encoding_solver_binding_identities = TestSingle{
+	"core encoding solver falls back for identities binding variables",
+	[]() {
+		const auto checker = cspc::create_encoding_solver(
+			cspc::majority_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable);
+		const auto cache = std::make_shared<cspc::core_cache>(1024);
+		const auto core_checker = cspc::create_core_encoding_solver(
+			cspc::majority_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable, cache);
+
+		const auto relations = cspc::all_nary_relations(2, 3);
+		auto expected = std::vector<cspc::satisfiability>{};
+		auto actual = std::vector<cspc::satisfiability>{};
+		std::ranges::transform(relations, std::back_inserter(expected), checker);
+		std::ranges::transform(relations, std::back_inserter(actual), core_checker);
+		return test_eq(
+			std::vector<bool>{actual == expected, cache->misses() == 0},
+			std::vector<bool>{true, true});
+	},
+};
+} // namespace
+
+const TestModule test_core = {
+	.description = "core tests",
+	.tests =
+		{
+			test_find_core,
+			test_core_cache,
+			test_core_encoding_solver,
+			test_core_encoding_solver_binding_identities,
+		},
+};
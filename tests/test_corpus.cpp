@@ -0,0 +1,88 @@
+#include "test_corpus.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/corpus.hpp>
+#include <cspc/formatters.hpp>
+#include <fstream>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto corpus_path() -> std::filesystem::path {
+	return std::filesystem::temp_directory_path() / "cspc_test_corpus.bin";
+}
+
+auto round_trip(size_t arity, size_t domain_size, std::vector<cspc::relation> const& relations)
+	-> std::vector<std::vector<cspc::relation_entry>> {
+	auto result = std::vector<std::vector<cspc::relation_entry>>{};
+	if (cspc::write_relation_corpus(corpus_path(), arity, domain_size, relations)) {
+		const auto corpus = cspc::relation_corpus::open(corpus_path());
+		for (auto i = size_t(0); corpus != nullptr && i < corpus->size(); ++i) {
+			result.push_back((*corpus)[i].to_relation().data());
+		}
+	}
+	std::filesystem::remove(corpus_path());
+	return result;
+}
+
+auto relation_data(std::vector<cspc::relation> const& relations)
+	-> std::vector<std::vector<cspc::relation_entry>> {
+	auto result = std::vector<std::vector<cspc::relation_entry>>{};
+	std::ranges::transform(relations, std::back_inserter(result), &cspc::relation::data);
+	return result;
+}
+
+const auto test_corpus_round_trip = TestBundle{
+	"corpus round trip",
+	{
+		[]() {
+			const auto relations = cspc::all_nary_relations(2, 3);
+			return test_eq(round_trip(2, 3, relations), relation_data(relations));
+		},
+		[]() {
+			// 27 tuples take 5 bits each, so some of them straddle two words
+			const auto relations = std::vector{
+				cspc::neq_relation(3, 3), cspc::relation(3), cspc::eq_relation(3, 3),
+				cspc::relation{{2, 2, 2}}};
+			return test_eq(round_trip(3, 3, relations), relation_data(relations));
+		},
+	},
+};
+
+const auto test_corpus_validation = TestBundle{
+	"corpus validation",
+	{
+		[]() {
+			cspc::write_relation_corpus(corpus_path(), 2, 3, cspc::all_nary_relations(2, 3));
+			std::filesystem::resize_file(
+				corpus_path(), std::filesystem::file_size(corpus_path()) - 8);
+			const auto corpus = cspc::relation_corpus::open(corpus_path());
+			std::filesystem::remove(corpus_path());
+			return test_eq(corpus == nullptr, true);
+		},
+		[]() {
+			{
+				auto ofs = std::ofstream(corpus_path());
+				ofs << std::string(128, 'x');
+			}
+			const auto corpus = cspc::relation_corpus::open(corpus_path());
+			std::filesystem::remove(corpus_path());
+			return test_eq(corpus == nullptr, true);
+		},
+		[]() {
+			const auto written =
+				cspc::write_relation_corpus(corpus_path(), 2, 2, {cspc::neq_relation(2, 3)});
+			std::filesystem::remove(corpus_path());
+			return test_eq(written, false);
+		},
+	},
+};
+} // namespace
+
+const TestModule test_corpus = {
+	.description = "corpus tests",
+	.tests =
+		{
+			test_corpus_round_trip,
+			test_corpus_validation,
+		},
+};
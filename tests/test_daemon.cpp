@@ -0,0 +1,99 @@
+#include "test_daemon.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/daemon.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto socket_path() -> std::filesystem::path {
+	return std::filesystem::temp_directory_path() / "cspc_test_daemon.sock";
+}
+
+auto create_checker() -> cspc::polymorphism_checker {
+	return cspc::create_encoding_solver(
+		cspc::siggers_operation(), cspc::multivalued_direct_encoding, cspc::kissat_is_satisfiable);
+}
+
+const auto daemon_options = cspc::daemon_options{
+	.n_threads = 3,
+	.result_cache_capacity = 1024,
+	.max_request_size = 1024,
+};
+
+const auto test_daemon_classification = TestBundle{
+	"daemon classification",
+	{
+		[]() {
+			// the second round is answered from the result cache
+			const auto relations = cspc::all_nary_relations(2, 3);
+			auto expected = std::vector<cspc::satisfiability>{};
+			std::ranges::transform(relations, std::back_inserter(expected), create_checker());
+			auto daemon = cspc::classification_daemon(create_checker, daemon_options);
+			daemon.listen(socket_path());
+			const auto first = cspc::classify_remote(socket_path(), relations);
+			const auto second = cspc::classify_remote(socket_path(), relations);
+			return test_eq(
+				std::vector{first.value_or(std::vector<cspc::satisfiability>{}),
+							second.value_or(std::vector<cspc::satisfiability>{}),
+							std::vector(daemon.n_cache_hits(), cspc::SATISFIABLE)},
+				std::vector{expected, expected, std::vector(relations.size(), cspc::SATISFIABLE)});
+		},
+		[]() {
+			// a request larger than the daemon accepts fails the whole query
+			auto daemon = cspc::classification_daemon(create_checker, daemon_options);
+			daemon.listen(socket_path());
+			auto large = cspc::relation(2);
+			for (auto i = 0u; i < 600; ++i) {
+				large.insert({i % 3, i / 3 % 3});
+			}
+			const auto results =
+				cspc::classify_remote(socket_path(), {cspc::neq_relation(2, 3), large});
+			return test_eq(results.has_value(), false);
+		},
+		[]() {
+			// the readers of finished clients are joined rather than kept until the daemon stops
+			const auto n_threads = []() {
+				return std::ranges::distance(
+					std::filesystem::directory_iterator("/proc/self/task"),
+					std::filesystem::directory_iterator{});
+			};
+			auto daemon = cspc::classification_daemon(create_checker, daemon_options);
+			daemon.listen(socket_path());
+			const auto n_before = n_threads();
+			for (auto i = 0; i < 32; ++i) {
+				cspc::classify_remote(socket_path(), {cspc::neq_relation(2, 3)});
+			}
+			return test_eq(n_threads() < n_before + 8, true);
+		},
+		[]() {
+			// a full result cache makes room for new relations by dropping the least recently
+			// used one
+			auto options = daemon_options;
+			options.result_cache_capacity = 1;
+			auto daemon = cspc::classification_daemon(create_checker, options);
+			daemon.listen(socket_path());
+			for (auto const& _relation :
+				 {cspc::neq_relation(2, 3), cspc::neq_relation(2, 3), cspc::eq_relation(2, 3),
+				  cspc::neq_relation(2, 3)}) {
+				cspc::classify_remote(socket_path(), {_relation});
+			}
+			return test_eq(daemon.n_cache_hits(), 1ul);
+		},
+		[]() {
+			const auto results = cspc::classify_remote(socket_path(), {cspc::neq_relation(2, 3)});
+			return test_eq(results.has_value(), false);
+		},
+	},
+};
+} // namespace
+
+const TestModule test_daemon = {
+	.description = "daemon tests",
+	.tests =
+		{
+			test_daemon_classification,
+		},
+};
@@ -2,11 +2,14 @@
 
 #include "cspc/algorithms.hpp"
 #include "cspc/data_structures.hpp"
+#include <cspc/encodings/auto.hpp>
 #include <cspc/encodings/binary.hpp>
 #include <cspc/encodings/direct.hpp>
 #include <cspc/encodings/label_cover.hpp>
+#include <cspc/encodings/mdd.hpp>
 #include <cspc/kissat.hpp>
 #include <gautil/formatters.hpp>
+#include <gautil/functional.hpp>
 #include <gautil/math.hpp>
 #include <gautil/misc.hpp>
 
@@ -222,6 +225,197 @@ auto test_encoding_simple(std::string const& name, Encoding encoding) -> TestBun
 	};
 }
 
+template <typename Encoding, typename Statistics>
+auto test_encoding_statistics(std::string const& name, Encoding encoding, Statistics statistics)
+	-> TestSingle {
+	return TestSingle{
+		name,
+		[encoding, statistics]() {
+			const auto csp = cspc::construct_preserves_operation_csp(
+				cspc::siggers_operation(), cspc::neq_relation(2, 3));
+			const auto sat = encoding(csp);
+			const auto n_literals =
+				gautil::fold(sat.clauses(), 0ul, std::plus{}, &cspc::clause::size);
+			const auto predicted = statistics(csp);
+			return test_eq(
+				std::vector<size_t>{predicted.n_clauses, predicted.n_literals},
+				std::vector<size_t>{sat.clauses().size(), n_literals});
+		},
+	};
+}
+
+auto flat(cspc::sat const& sat) -> std::vector<i32> {
+	auto result = std::vector<i32>{};
+	for (auto const& _clause : sat.clauses()) {
+		std::ranges::transform(_clause, std::back_inserter(result), &cspc::literal::value);
+		result.push_back(0);
+	}
+	return result;
+}
+
+template <typename Encoding, typename ParallelEncoding>
+auto test_parallel_encoding(
+	std::string const& name, Encoding encoding, ParallelEncoding create_parallel_encoding)
+	-> TestBundle {
+	auto tests = std::vector<std::function<TestResult()>>{};
+	for (const auto n_threads : {1ul, 3ul, 8ul}) {
+		tests.push_back([encoding, create_parallel_encoding, n_threads]() {
+			const auto parallel_encoding = create_parallel_encoding(n_threads);
+			auto serial = std::vector<i32>{};
+			auto parallel = std::vector<i32>{};
+			for (auto const& relation : cspc::all_nary_relations(2, 2)) {
+				const auto csp =
+					cspc::construct_preserves_operation_csp(cspc::siggers_operation(), relation);
+				std::ranges::copy(flat(encoding(csp)), std::back_inserter(serial));
+				std::ranges::copy(flat(parallel_encoding(csp)), std::back_inserter(parallel));
+			}
+			const auto csp = cspc::construct_preserves_operation_csp(
+				cspc::siggers_operation(), cspc::neq_relation(2, 3));
+			std::ranges::copy(flat(encoding(csp)), std::back_inserter(serial));
+			std::ranges::copy(flat(parallel_encoding(csp)), std::back_inserter(parallel));
+			return test_eq(parallel, serial);
+		});
+	}
+	return TestBundle{name, std::move(tests)};
+}
+
+const auto test_label_cover_shared_blocks = TestBundle{
+	"test label cover shared blocks",
+	{
+		[]() {
+			const auto constraints = std::vector<cspc::constraint>{
+				cspc::constraint(cspc::eq_relation(2, 2), {0, 1}),
+				cspc::constraint(cspc::neq_relation(2, 2), {0, 1}),
+				cspc::constraint(cspc::eq_relation(2, 2), {0, 1}),
+				cspc::constraint(cspc::eq_relation(2, 2), {1, 0}),
+			};
+			const auto csp = cspc::csp(constraints);
+			const auto distinct = cspc::__internal::distinct_label_cover_blocks(csp);
+			const auto expected = cspc::csp(
+				{constraints[0], constraints[1], constraints[3]}, csp.n_variables(),
+				csp.domain_size());
+			return test_eq(
+				flat(cspc::label_cover_encoding(csp)), flat(cspc::label_cover_encoding(expected)));
+		},
+		[]() {
+			// a majority operation's identities repeat constraints on the constant inputs
+			const auto csp = cspc::construct_preserves_operation_csp(
+				cspc::majority_operation(), cspc::neq_relation(2, 3));
+			const auto sat = cspc::multivalued_label_cover_encoding(csp);
+			const auto n_literals =
+				gautil::fold(sat.clauses(), 0ul, std::plus{}, &cspc::clause::size);
+			const auto predicted = cspc::multivalued_label_cover_encoding_statistics(csp);
+			const auto n_distinct =
+				cspc::__internal::distinct_label_cover_blocks(csp).constraints().size();
+			const auto shares_blocks = n_distinct < csp.constraints().size();
+			return test_eq(
+				std::vector<size_t>{predicted.n_clauses, predicted.n_literals, shares_blocks},
+				std::vector<size_t>{sat.clauses().size(), n_literals, true});
+		},
+		[]() {
+			const auto has_majority_operation = cspc::create_encoding_solver(
+				cspc::majority_operation(), cspc::label_cover_encoding,
+				cspc::kissat_is_satisfiable);
+			return test_eq(
+				std::vector{
+					has_majority_operation(cspc::neq_relation(2, 2)),
+					has_majority_operation(cspc::neq_relation(2, 3)),
+				},
+				std::vector{cspc::SATISFIABLE, cspc::UNSATISFIABLE});
+		},
+	},
+};
+
+const auto test_compile_mdd = TestBundle{
+	"test compile mdd",
+	{
+		[]() {
+			// a root, and a node per value on each of the two inner layers
+			const auto diagram = cspc::__internal::compile_mdd(cspc::eq_relation(3, 3), 3);
+			return test_eq(diagram.n_nodes(), 7ul);
+		},
+		[]() {
+			// the first value is free, and the second must differ from the third
+			auto entries = std::vector<cspc::relation_entry>{};
+			for (auto a = cspc::domain_value(0); a < 3; ++a) {
+				for (auto const& entry : cspc::neq_relation(2, 3)) {
+					entries.push_back({a, entry[0], entry[1]});
+				}
+			}
+			const auto diagram = cspc::__internal::compile_mdd(cspc::relation(entries), 3);
+			return test_eq(
+				std::vector<bool>{diagram.n_nodes() == 5, diagram.has_single_child(diagram.root())},
+				std::vector<bool>{true, true});
+		},
+		[]() {
+			const auto full = cspc::__internal::compile_mdd(
+				cspc::relation(cspc::create_all_tuples(2, 3)), 3);
+			return test_eq(
+				std::vector<u32>{u32(full.n_nodes()), full.child(full.root(), 1)},
+				std::vector<u32>{1, cspc::__internal::MDD_ACCEPT});
+		},
+	},
+};
+
+const auto test_minimize_cover = TestBundle{
+	"test minimize cover",
+	{
+		[]() {
+			// the minterms with the third bit clear are one cube
+			auto truth_table =
+				std::vector<cspc::__internal::minterm_status>(8, cspc::__internal::MINTERM_OFF);
+			std::fill_n(truth_table.begin(), 4, cspc::__internal::MINTERM_ON);
+			const auto cover = cspc::__internal::minimize_cover(truth_table, 3);
+			return test_eq(
+				std::vector<u32>{u32(cover.size()), cover[0].mask, cover[0].value},
+				std::vector<u32>{1, 0b100, 0});
+		},
+		[]() {
+			// 5, 6 and 7 are 1?1 and 11?
+			const auto cubes = cspc::__internal::prohibited_value_cubes(5, 3);
+			return test_eq(cubes.size(), 2ul);
+		},
+		[]() {
+			const auto csp = cspc::construct_preserves_operation_csp(
+				cspc::siggers_operation(), cspc::neq_relation(2, 3));
+			const auto inclusive_domain_size = size_t(1) << cspc::__internal::n_bits(3);
+			const auto n_nogoods =
+				gautil::fold(csp.constraints(), 0ul, std::plus{}, [&](auto const& constraint) {
+					return cspc::__internal::n_nogoods(constraint, inclusive_domain_size);
+				});
+			return test_eq(cspc::binary_encoding(csp).clauses().size() < n_nogoods, true);
+		},
+	},
+};
+
+const auto test_wide_relation_encoding = TestSingle{
+	"test wide relation encoding",
+	[]() {
+		// 17 values of 2 bits are too wide for a cube, so the log encoding falls back to a clause
+		// per nogood
+		const auto arity = size_t(17);
+		auto scope = std::vector<cspc::variable>(arity);
+		std::iota(scope.begin(), scope.end(), cspc::variable(0));
+		auto ones = cspc::relation_entry(arity);
+		std::ranges::fill(ones, 1);
+		const auto constraints = std::vector<cspc::constraint>{
+			cspc::constraint(cspc::relation{ones}, scope),
+			cspc::constraint(cspc::relation{cspc::relation_entry{0}}, {cspc::variable(arity - 1)}),
+		};
+		const auto csp = cspc::csp(constraints, arity, 2);
+		const auto sat = cspc::log_encoding(csp);
+		return test_eq(
+			std::vector<size_t>{
+				size_t(cspc::kissat_is_satisfiable(sat)),
+				cspc::log_encoding_statistics(csp).n_clauses,
+			},
+			std::vector<size_t>{
+				size_t(cspc::kissat_is_satisfiable(cspc::direct_encoding(csp))),
+				sat.clauses().size(),
+			});
+	},
+};
+
 const TestModule test_encodings = {
 	"test encodings",
 	{
@@ -233,6 +427,10 @@ const TestModule test_encodings = {
 		test_encoding_simple("test label cover encoding simple", cspc::label_cover_encoding),
 		test_encoding_simple(
 			"test multivalued label cover encoding", cspc::multivalued_label_cover_encoding),
+		test_encoding_simple("test mdd encoding simple", cspc::mdd_encoding),
+		test_encoding_simple(
+			"test multivalued mdd encoding simple", cspc::multivalued_mdd_encoding),
+		test_encoding_simple("test auto encoding simple", cspc::auto_encoding),
 		test_encoding_full("test direct encoding pipeline", cspc::direct_encoding),
 		test_encoding_full(
 			"test multivalued direct encoding pipeline", cspc::multivalued_direct_encoding),
@@ -242,4 +440,48 @@ const TestModule test_encodings = {
 		test_encoding_full(
 			"test multivalued label cover encoding pipeline",
 			cspc::multivalued_label_cover_encoding),
+		test_encoding_full("test mdd encoding pipeline", cspc::mdd_encoding),
+		test_encoding_full(
+			"test multivalued mdd encoding pipeline", cspc::multivalued_mdd_encoding),
+		test_encoding_full("test auto encoding pipeline", cspc::auto_encoding),
+		test_encoding_statistics(
+			"test direct encoding statistics", cspc::direct_encoding,
+			cspc::direct_encoding_statistics),
+		test_encoding_statistics(
+			"test multivalued direct encoding statistics", cspc::multivalued_direct_encoding,
+			cspc::multivalued_direct_encoding_statistics),
+		test_encoding_statistics(
+			"test binary encoding statistics", cspc::binary_encoding,
+			cspc::binary_encoding_statistics),
+		test_encoding_statistics(
+			"test log encoding statistics", cspc::log_encoding, cspc::log_encoding_statistics),
+		test_encoding_statistics(
+			"test label cover encoding statistics", cspc::label_cover_encoding,
+			cspc::label_cover_encoding_statistics),
+		test_encoding_statistics(
+			"test multivalued label cover encoding statistics",
+			cspc::multivalued_label_cover_encoding,
+			cspc::multivalued_label_cover_encoding_statistics),
+		test_encoding_statistics(
+			"test mdd encoding statistics", cspc::mdd_encoding, cspc::mdd_encoding_statistics),
+		test_encoding_statistics(
+			"test multivalued mdd encoding statistics", cspc::multivalued_mdd_encoding,
+			cspc::multivalued_mdd_encoding_statistics),
+		test_parallel_encoding(
+			"test parallel direct encoding", cspc::direct_encoding,
+			cspc::create_parallel_direct_encoding),
+		test_parallel_encoding(
+			"test parallel multivalued direct encoding", cspc::multivalued_direct_encoding,
+			cspc::create_parallel_multivalued_direct_encoding),
+		test_parallel_encoding(
+			"test parallel label cover encoding", cspc::label_cover_encoding,
+			cspc::create_parallel_label_cover_encoding),
+		test_parallel_encoding(
+			"test parallel multivalued label cover encoding",
+			cspc::multivalued_label_cover_encoding,
+			cspc::create_parallel_multivalued_label_cover_encoding),
+		test_label_cover_shared_blocks,
+		test_compile_mdd,
+		test_minimize_cover,
+		test_wide_relation_encoding,
 	}};
@@ -0,0 +1,119 @@
+#include "test_external_solver.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/external_solver.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <future>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto stand_in_options(std::vector<std::string> arguments = {}) -> cspc::external_solver_options {
+	arguments.insert(arguments.begin(), CSPC_STAND_IN_SOLVER);
+	return cspc::external_solver_options{
+		.command = std::move(arguments),
+		.max_processes = 2,
+		.time_limit = std::chrono::milliseconds(0),
+		.memory_limit_bytes = 0,
+	};
+}
+
+const auto test_dimacs = TestBundle{
+	"dimacs",
+	{
+		[]() {
+			const auto sat = cspc::sat{
+				cspc::clause{cspc::literal{0, cspc::REGULAR}, cspc::literal{2, cspc::NEGATED}},
+				cspc::clause{cspc::literal{1, cspc::NEGATED}},
+			};
+			return test_eq(cspc::to_dimacs(sat), std::string{"p cnf 3 2\n1 -3 0\n-2 0\n"});
+		},
+		[]() {
+			return test_eq(
+				std::vector{
+					cspc::parse_dimacs_result("c comment\ns SATISFIABLE\nv 1 -2 0\n"),
+					cspc::parse_dimacs_result("s UNSATISFIABLE\r\n"),
+					cspc::parse_dimacs_result("s UNKNOWN\n"),
+					cspc::parse_dimacs_result(""),
+				},
+				std::vector<std::optional<cspc::satisfiability>>{
+					cspc::SATISFIABLE, cspc::UNSATISFIABLE, std::nullopt, std::nullopt});
+		},
+	},
+};
+
+const auto test_external_solver_pool = TestSingle{
+	"external solver pool",
+	[]() {
+		const auto pool = std::make_shared<cspc::external_solver_pool>(stand_in_options());
+		const auto relations = cspc::all_nary_relations(2, 2);
+
+		// more concurrent callers than processes
+		auto expected = std::vector<std::optional<cspc::satisfiability>>{};
+		auto futures = std::vector<std::future<std::optional<cspc::satisfiability>>>{};
+		for (auto const& relation : relations) {
+			for (auto const& operation : {cspc::siggers_operation(), cspc::majority_operation()}) {
+				const auto sat = cspc::direct_encoding(
+					cspc::construct_preserves_operation_csp(operation, relation));
+				expected.push_back(cspc::kissat_is_satisfiable(sat));
+				futures.push_back(
+					std::async(std::launch::async, [pool, sat]() { return pool->solve(sat); }));
+			}
+		}
+		auto actual = std::vector<std::optional<cspc::satisfiability>>{};
+		for (auto& future : futures) {
+			actual.push_back(future.get());
+		}
+		return test_eq(actual, expected);
+	},
+};
+
+const auto test_external_solver_failures = TestBundle{
+	"external solver failures",
+	{
+		[]() {
+			const auto unsatisfiable = cspc::sat{
+				cspc::clause{cspc::literal{0, cspc::REGULAR}},
+				cspc::clause{cspc::literal{0, cspc::NEGATED}},
+			};
+			auto actual = std::vector<std::optional<cspc::satisfiability>>{};
+			for (auto const& mode : {"--silent", "--crash", "--unknown"}) {
+				auto pool = cspc::external_solver_pool(stand_in_options({mode}));
+				actual.push_back(pool.solve(unsatisfiable));
+			}
+			auto missing = cspc::external_solver_pool(cspc::external_solver_options{
+				.command = {"/nonexistent/cspc_solver"},
+				.max_processes = 1,
+				.time_limit = std::chrono::milliseconds(0),
+				.memory_limit_bytes = 0,
+			});
+			actual.push_back(missing.solve(unsatisfiable));
+			return test_eq(
+				actual,
+				std::vector<std::optional<cspc::satisfiability>>{
+					cspc::UNSATISFIABLE, std::nullopt, std::nullopt, std::nullopt});
+		},
+		[]() {
+			auto options = stand_in_options({"--hang"});
+			options.time_limit = std::chrono::milliseconds(200);
+			const auto pool = std::make_shared<cspc::external_solver_pool>(options);
+			const auto solver = cspc::create_external_solver(pool, cspc::kissat_is_satisfiable);
+			const auto sat = cspc::sat{cspc::clause{cspc::literal{0, cspc::REGULAR}}};
+			return test_eq(
+				std::vector<bool>{!pool->solve(sat).has_value(), solver(sat) == cspc::SATISFIABLE},
+				std::vector<bool>{true, true});
+		},
+	},
+};
+} // namespace
+
+const TestModule test_external_solver = {
+	.description = "external solver tests",
+	.tests =
+		{
+			test_dimacs,
+			test_external_solver_pool,
+			test_external_solver_failures,
+		},
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "test.hpp"
+
+extern const TestModule test_external_solver;
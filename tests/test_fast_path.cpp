@@ -0,0 +1,99 @@
+#include "test_fast_path.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/fast_path.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto fired_rule(cspc::operation const& operation, cspc::relation const& relation)
+	-> std::optional<size_t> {
+	const auto decision =
+		cspc::classify_fast_path(operation, relation, cspc::default_fast_path_rules());
+	if (!decision.has_value()) {
+		return std::nullopt;
+	}
+	return decision->rule;
+}
+
+const auto test_fast_path_rules = TestBundle{
+	"fast path rules",
+	{
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::relation(2)), std::optional{0ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(
+					cspc::siggers_operation(), cspc::relation(cspc::create_all_tuples(2, 3))),
+				std::optional{1ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::relation{{1, 0}, {2, 2}}),
+				std::optional{2ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::relation{{1, 0}, {0, 1}, {0, 0}}),
+				std::optional{2ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::relation{{1, 0}, {0, 2}, {0, 0}}),
+				std::optional{2ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::relation{{1, 0}, {2, 1}, {2, 0}}),
+				std::optional{3ul});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::siggers_operation(), cspc::neq_relation(2, 3)),
+				std::optional<size_t>{});
+		},
+		[]() {
+			return test_eq(
+				fired_rule(cspc::majority_operation(), cspc::eq_relation(2, 3)),
+				std::optional<size_t>{});
+		},
+	},
+};
+
+const auto test_fast_path_checker = TestSingle{
+	"fast path checker agrees with solver",
+	[]() {
+		const auto checker = cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable);
+		const auto statistics = std::make_shared<cspc::fast_path_statistics>(
+			cspc::default_fast_path_rules().size());
+		const auto fast_path_checker = cspc::create_fast_path_checker(
+			cspc::siggers_operation(), cspc::default_fast_path_rules(), checker, statistics);
+
+		auto expected = std::vector<cspc::satisfiability>{};
+		auto actual = std::vector<cspc::satisfiability>{};
+		for (auto const& relations :
+			 {cspc::all_nary_relations(2, 3), cspc::all_nary_relations(3, 2)}) {
+			std::ranges::transform(relations, std::back_inserter(expected), checker);
+			std::ranges::transform(relations, std::back_inserter(actual), fast_path_checker);
+		}
+		const auto n_decided = statistics->hits(2) + statistics->hits(3);
+		return test_eq(
+			std::vector<size_t>{actual == expected, n_decided + statistics->misses()},
+			std::vector<size_t>{true, expected.size()});
+	},
+};
+} // namespace
+
+const TestModule test_fast_path = {
+	.description = "fast path tests",
+	.tests =
+		{
+			test_fast_path_rules,
+			test_fast_path_checker,
+		},
+};
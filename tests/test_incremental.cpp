@@ -0,0 +1,104 @@
+#include "test_incremental.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/incremental.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto n_differing_tuples(cspc::relation const& lhs, cspc::relation const& rhs) -> size_t {
+	auto lhs_sorted = lhs.data();
+	auto rhs_sorted = rhs.data();
+	std::ranges::sort(lhs_sorted);
+	std::ranges::sort(rhs_sorted);
+	auto difference = std::vector<cspc::relation_entry>{};
+	std::ranges::set_symmetric_difference(lhs_sorted, rhs_sorted, std::back_inserter(difference));
+	return difference.size();
+}
+
+auto sorted_clauses(cspc::sat const& sat) -> std::vector<std::vector<i64>> {
+	auto result = std::vector<std::vector<i64>>{};
+	for (auto const& _clause : sat.clauses()) {
+		auto values = std::vector<i64>{};
+		std::ranges::transform(_clause, std::back_inserter(values), &cspc::literal::value);
+		result.push_back(std::move(values));
+	}
+	std::ranges::sort(result);
+	return result;
+}
+
+const auto test_gray_code_relations = TestSingle{
+	"gray code relations",
+	[]() {
+		const auto relations = cspc::gray_code_nary_relations(2, 3);
+		auto neighbors_differ_by_one = true;
+		for (auto i = size_t(1); i < relations.size(); ++i) {
+			neighbors_differ_by_one &= n_differing_tuples(relations[i - 1], relations[i]) == 1;
+		}
+		return test_eq(
+			std::vector{relations.size(), size_t(neighbors_differ_by_one)},
+			std::vector{cspc::all_nary_relations(2, 3).size(), size_t(1)});
+	},
+};
+
+const auto test_incremental_delta = TestBundle{
+	"incremental meta-csp delta",
+	{
+		[]() {
+			auto meta_csp = cspc::incremental_meta_csp(
+				cspc::siggers_operation(), 2, 2, cspc::multivalued_direct_encoding);
+			const auto inserted = meta_csp.insert({0, 1});
+			const auto erased = meta_csp.erase({0, 1});
+			return test_eq(
+				std::vector{inserted.added.size(), erased.removed.size(), erased.added.size()},
+				std::vector<size_t>{3, 3, 0});
+		},
+		[]() {
+			// the encoding is the same whichever way the relation was reached
+			auto meta_csp = cspc::incremental_meta_csp(
+				cspc::siggers_operation(), 2, 3, cspc::multivalued_direct_encoding);
+			meta_csp.assign(cspc::neq_relation(2, 3));
+			meta_csp.assign(cspc::relation{{0, 1}, {2, 0}});
+			auto expected = cspc::incremental_meta_csp(
+				cspc::siggers_operation(), 2, 3, cspc::multivalued_direct_encoding);
+			expected.assign(cspc::relation{{2, 0}, {0, 1}});
+			return test_eq(sorted_clauses(meta_csp.encoded()), sorted_clauses(expected.encoded()));
+		},
+	},
+};
+
+template <typename Encoding>
+auto test_incremental_checker(std::string const& name, Encoding encoding) -> TestSingle {
+	return TestSingle{
+		name,
+		[encoding]() {
+			const auto checker = cspc::create_encoding_solver(
+				cspc::siggers_operation(), encoding, cspc::kissat_is_satisfiable);
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto actual = std::vector<cspc::satisfiability>{};
+			for (auto const& [n, domain_size] : {std::pair{2, 3}, std::pair{3, 2}}) {
+				const auto relations = cspc::gray_code_nary_relations(n, domain_size);
+				const auto incremental_checker = cspc::create_incremental_encoding_solver(
+					cspc::siggers_operation(), domain_size, encoding, cspc::kissat_is_satisfiable);
+				std::ranges::transform(relations, std::back_inserter(expected), checker);
+				std::ranges::transform(relations, std::back_inserter(actual), incremental_checker);
+			}
+			return test_eq(actual, expected);
+		},
+	};
+}
+} // namespace
+
+const TestModule test_incremental = {
+	.description = "incremental tests",
+	.tests =
+		{
+			test_gray_code_relations,
+			test_incremental_delta,
+			test_incremental_checker("incremental checker direct encoding", cspc::direct_encoding),
+			test_incremental_checker(
+				"incremental checker multivalued direct encoding",
+				cspc::multivalued_direct_encoding),
+		},
+};
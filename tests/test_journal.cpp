@@ -0,0 +1,80 @@
+#include "test_journal.hpp"
+
+#include <cspc/journal.hpp>
+#include <fstream>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto journal_path() -> std::filesystem::path {
+	return std::filesystem::temp_directory_path() / "cspc_test_journal.txt";
+}
+
+auto entry_indices(std::vector<cspc::journal_entry> const& entries) -> std::vector<size_t> {
+	auto indices = std::vector<size_t>{};
+	std::ranges::transform(entries, std::back_inserter(indices), &cspc::journal_entry::index);
+	return indices;
+}
+
+const auto test_journal_resume = TestBundle{
+	"journal resume",
+	{
+		[]() {
+			std::filesystem::remove(journal_path());
+			{
+				auto journal = cspc::journal::open(journal_path(), "test");
+				journal->record(cspc::journal_entry{3, cspc::SATISFIABLE, 10});
+				journal->record(cspc::journal_entry{5, cspc::UNSATISFIABLE, 20});
+			}
+			auto journal = cspc::journal::open(journal_path(), "test");
+			const auto result = std::vector{
+				journal->find(3).has_value(), journal->find(4).has_value(),
+				journal->find(5).has_value() &&
+					journal->find(5)->result == cspc::UNSATISFIABLE};
+			journal.reset();
+			std::filesystem::remove(journal_path());
+			return test_eq(result, std::vector{true, false, true});
+		},
+		[]() {
+			std::filesystem::remove(journal_path());
+			cspc::journal::open(journal_path(), "test");
+			const auto journal = cspc::journal::open(journal_path(), "other");
+			std::filesystem::remove(journal_path());
+			return test_eq(journal == nullptr, true);
+		},
+	},
+};
+
+const auto test_journal_torn_record = TestSingle{
+	"journal torn record",
+	[]() {
+		std::filesystem::remove(journal_path());
+		{
+			auto journal = cspc::journal::open(journal_path(), "test");
+			journal->record(cspc::journal_entry{0, cspc::SATISFIABLE, 10});
+		}
+		{
+			// a crash in the middle of a write
+			auto ofs = std::ofstream(journal_path(), std::ios::app);
+			ofs << "1 0";
+		}
+		{
+			auto journal = cspc::journal::open(journal_path(), "test");
+			journal->record(cspc::journal_entry{2, cspc::SATISFIABLE, 30});
+		}
+		const auto entries = cspc::load_journal(journal_path(), "test");
+		std::filesystem::remove(journal_path());
+		return test_eq(
+			entries.has_value() ? entry_indices(entries.value()) : std::vector<size_t>{},
+			std::vector<size_t>{0, 2});
+	},
+};
+} // namespace
+
+const TestModule test_journal = {
+	.description = "journal tests",
+	.tests =
+		{
+			test_journal_resume,
+			test_journal_torn_record,
+		},
+};
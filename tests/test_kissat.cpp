@@ -1,6 +1,9 @@
 #include "test_kissat.hpp"
 
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
 #include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
 
 namespace {
 const auto test_kissat_simple = TestBundle{
@@ -48,6 +51,72 @@ const auto test_kissat_simple = TestBundle{
 		},
 	},
 };
+
+const auto test_kissat_model = TestBundle{
+	"test kissat model",
+	{
+		[]() {
+			return test_eq(
+				cspc::kissat_find_model(cspc::sat{
+					cspc::clause{cspc::literal{0, cspc::NEGATED}, cspc::literal{1, cspc::REGULAR}},
+					cspc::clause{cspc::literal{1, cspc::NEGATED}},
+					cspc::clause{cspc::literal{0, cspc::REGULAR}, cspc::literal{2, cspc::REGULAR}},
+				}),
+				std::optional{cspc::assignment{false, false, true}});
+		},
+		[]() {
+			return test_eq(
+				cspc::kissat_find_model(cspc::sat{
+					cspc::clause{cspc::literal{1, cspc::REGULAR}},
+					cspc::clause{cspc::literal{1, cspc::NEGATED}},
+				}),
+				std::optional<cspc::assignment>{});
+		},
+	},
+};
+
+const auto test_kissat_presets = TestBundle{
+	"test kissat presets",
+	{
+		[]() {
+			// every preset only changes how kissat searches, never the answer
+			const auto relations = cspc::all_nary_relations(2, 2);
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto results = std::vector<std::vector<cspc::satisfiability>>{};
+			std::ranges::transform(
+				relations, std::back_inserter(expected),
+				cspc::create_encoding_solver(
+					cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+					cspc::kissat_is_satisfiable));
+			for (auto const& preset : cspc::kissat_presets()) {
+				const auto checker = cspc::create_encoding_solver(
+					cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+					cspc::create_kissat_solver(preset.options));
+				std::ranges::transform(relations, std::back_inserter(results.emplace_back()), checker);
+			}
+			return test_eq(results, std::vector(cspc::kissat_presets().size(), expected));
+		},
+		[]() {
+			const auto solver = cspc::create_kissat_model_solver(cspc::kissat_options{
+				.configuration = "unsat",
+				.options = {{"eliminate", 0}},
+			});
+			return test_eq(
+				solver(cspc::sat{
+					cspc::clause{cspc::literal{0, cspc::NEGATED}, cspc::literal{1, cspc::REGULAR}},
+					cspc::clause{cspc::literal{1, cspc::NEGATED}},
+				}),
+				std::optional{cspc::assignment{false, false}});
+		},
+		[]() {
+			return test_eq(
+				std::vector{
+					cspc::find_kissat_preset("unsat").has_value(),
+					cspc::find_kissat_preset("fast").has_value()},
+				std::vector{true, false});
+		},
+	},
+};
 }
 
 const TestModule test_kissat = {
@@ -55,5 +124,7 @@ const TestModule test_kissat = {
 	.tests =
 		{
 			test_kissat_simple,
+			test_kissat_model,
+			test_kissat_presets,
 		},
 };
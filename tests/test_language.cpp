@@ -0,0 +1,114 @@
+#include "test_language.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/encodings/label_cover.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/language.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto mixed_language() -> cspc::constraint_language {
+	return {
+		cspc::neq_relation(2, 3),
+		cspc::relation{{0}, {2}},
+		cspc::relation{{0, 1, 2}, {2, 2, 0}, {1, 0, 0}},
+	};
+}
+
+auto describe(cspc::csp const& csp) -> std::vector<std::string> {
+	auto result = std::vector<std::string>{};
+	std::ranges::transform(csp.constraints(), std::back_inserter(result), [](auto const& c) {
+		return fmt::format("{}", c);
+	});
+	return result;
+}
+
+const auto test_language_construction = TestSingle{
+	"language meta-CSP construction",
+	[]() {
+		const auto siggers = cspc::siggers_operation();
+		const auto language = mixed_language();
+		// the identities followed by one block of |R|^4 constraints per relation
+		auto n_constraints =
+			cspc::__internal::construct_operation_identity_constraints(siggers, 3).size();
+		for (auto const& relation : language) {
+			n_constraints += (size_t)std::pow(relation.size(), 4);
+		}
+		const auto serial = cspc::construct_preserves_operation_csp(siggers, language);
+		auto expected = std::vector<std::string>{fmt::format("{}", n_constraints)};
+		auto actual = std::vector<std::string>{fmt::format("{}", serial.constraints().size())};
+		for (const auto n_threads : {2ul, 7ul}) {
+			std::ranges::copy(describe(serial), std::back_inserter(expected));
+			std::ranges::copy(
+				describe(cspc::construct_preserves_operation_csp(siggers, language, n_threads)),
+				std::back_inserter(actual));
+		}
+		return test_eq(actual, expected);
+	},
+};
+
+auto test_language_encoding_solver(std::string const& name, cspc::encoding encoding)
+	-> TestSingle {
+	return TestSingle{
+		name,
+		[encoding]() {
+			const auto siggers = cspc::siggers_operation();
+			const auto checker = cspc::create_language_encoding_solver(
+				siggers, encoding, cspc::kissat_is_satisfiable);
+
+			// grown one relation at a time, then restarted on a smaller domain
+			auto languages = std::vector<cspc::constraint_language>{};
+			auto language = cspc::constraint_language{};
+			for (auto const& relation : mixed_language()) {
+				language.push_back(relation);
+				languages.push_back(language);
+			}
+			for (auto const& relation : cspc::all_nary_relations(2, 2)) {
+				languages.push_back({cspc::relation{{0, 1}, {1, 0}}, relation});
+			}
+
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto actual = std::vector<cspc::satisfiability>{};
+			for (auto const& language : languages) {
+				expected.push_back(cspc::kissat_is_satisfiable(
+					encoding(cspc::construct_preserves_operation_csp(siggers, language))));
+				actual.push_back(checker(language));
+			}
+			return test_eq(actual, expected);
+		},
+	};
+}
+
+const auto test_language_clauses = TestSingle{
+	"language meta-CSP clauses",
+	[]() {
+		// the clauses on the variables alone appear once, however many relations are inserted
+		const auto siggers = cspc::siggers_operation();
+		auto meta_csp = cspc::language_meta_csp(siggers, 3, cspc::direct_encoding);
+		for (auto const& relation : mixed_language()) {
+			meta_csp.insert(relation);
+		}
+		// over the function table and one variable per domain value, as the language meta-CSP is
+		const auto n_variables = size_t(3 * 3 * 3 * 3 + 3);
+		const auto full = cspc::direct_encoding(cspc::csp(
+			cspc::construct_preserves_operation_csp(siggers, mixed_language()).constraints(),
+			n_variables, 3));
+		return test_eq(meta_csp.encoded().clauses().size(), full.clauses().size());
+	},
+};
+} // namespace
+
+const TestModule test_language = {
+	.description = "constraint language tests",
+	.tests =
+		{
+			test_language_construction,
+			test_language_clauses,
+			test_language_encoding_solver(
+				"language encoding solver direct encoding", cspc::direct_encoding),
+			test_language_encoding_solver(
+				"language encoding solver label cover encoding", cspc::label_cover_encoding),
+		},
+};
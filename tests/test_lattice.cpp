@@ -0,0 +1,85 @@
+#include "test_lattice.hpp"
+
+#include <bit>
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/lattice.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+const auto test_symmetric_chains = TestSingle{
+	"symmetric chains",
+	[]() {
+		auto expected = std::vector<bool>{};
+		auto actual = std::vector<bool>{};
+		for (const auto n : {0ul, 1ul, 4ul, 7ul}) {
+			const auto chains = cspc::symmetric_chains(n);
+			auto seen = std::vector<size_t>(size_t(1) << n);
+			auto covers = true;
+			auto symmetric = true;
+			for (auto const& chain : chains) {
+				const auto ranks = std::popcount(chain.front()) + std::popcount(chain.back());
+				symmetric = symmetric && size_t(ranks) == n;
+				for (auto i = size_t(0); i < chain.size(); ++i) {
+					++seen[chain[i]];
+					if (i > 0) {
+						const auto added = chain[i] ^ chain[i - 1];
+						covers = covers && (chain[i] & chain[i - 1]) == chain[i - 1] &&
+								 std::popcount(added) == 1;
+					}
+				}
+			}
+			covers = covers && std::ranges::all_of(seen, [](size_t k) { return k == 1; });
+			// as many chains as subsets of the middle rank
+			const auto n_middle = std::ranges::count_if(
+				std::views::iota(u64(0), u64(1) << n),
+				[&](u64 subset) { return size_t(std::popcount(subset)) == n / 2; });
+			actual.insert(actual.end(), {covers, symmetric, i64(chains.size()) == n_middle});
+			expected.insert(expected.end(), {true, true, true});
+		}
+		return test_eq(actual, expected);
+	},
+};
+
+const auto test_sweep_language_lattice = TestSingle{
+	"sweep language lattice",
+	[]() {
+		auto pool = cspc::all_nary_relations(2, 2);
+		pool.push_back(cspc::relation{{0}});
+		pool.push_back(cspc::relation{{0, 1}, {1, 0}});
+		pool.push_back(cspc::relation{{0, 0, 1}, {0, 1, 0}, {1, 0, 0}});
+		const auto checker = cspc::create_language_encoding_solver(
+			cspc::siggers_operation(), cspc::__internal::find_language_domain_size(pool),
+			cspc::direct_encoding, cspc::kissat_is_satisfiable);
+		const auto sweep = cspc::sweep_language_lattice(pool, checker);
+
+		auto expected = std::vector<cspc::satisfiability>{};
+		auto actual = std::vector<cspc::satisfiability>{};
+		for (auto subset = u64(0); subset < sweep.results.size(); ++subset) {
+			expected.push_back(checker(cspc::sublanguage(pool, subset)));
+			actual.push_back(sweep.results[subset].result);
+		}
+		const auto n_inferred =
+			std::ranges::count(sweep.results, true, &cspc::lattice_result::inferred);
+		return test_eq(
+			std::vector<bool>{
+				actual == expected,
+				sweep.n_solved + sweep.n_inferred == sweep.results.size(),
+				size_t(n_inferred) == sweep.n_inferred,
+				sweep.n_solved < sweep.results.size(),
+			},
+			std::vector<bool>{true, true, true, true});
+	},
+};
+} // namespace
+
+const TestModule test_lattice = {
+	.description = "language lattice tests",
+	.tests =
+		{
+			test_symmetric_chains,
+			test_sweep_language_lattice,
+		},
+};
@@ -0,0 +1,114 @@
+#include "test_metrics.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/metrics.hpp>
+#include <fstream>
+#include <gautil/formatters.hpp>
+#include <gautil/system.hpp>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+auto metrics_path() -> std::filesystem::path {
+	return std::filesystem::temp_directory_path() / "cspc_test_metrics";
+}
+
+auto example_registry(cspc::metrics_registry& registry) -> void {
+	registry.counter("test_requests_total", "Requests", {{"kind", "a \"quoted\" label"}}).add(2);
+	registry.gauge("test_depth", "Depth").add(-3);
+	auto& histogram = registry.histogram("test_values", "Values", 1.0);
+	for (const auto value : {0, 3, 100}) {
+		histogram.record(u64(value));
+	}
+}
+
+const auto test_metrics_export = TestBundle{
+	"metrics export",
+	{
+		[]() {
+			auto registry = cspc::metrics_registry{};
+			example_registry(registry);
+			return test_eq(
+				registry.prometheus_text(),
+				std::string("# HELP test_requests_total Requests\n"
+							"# TYPE test_requests_total counter\n"
+							"test_requests_total{kind=\"a \\\"quoted\\\" label\"} 2\n"
+							"# HELP test_depth Depth\n"
+							"# TYPE test_depth gauge\n"
+							"test_depth -3\n"
+							"# HELP test_values Values\n"
+							"# TYPE test_values histogram\n"
+							"test_values_bucket{le=\"0\"} 1\n"
+							"test_values_bucket{le=\"1\"} 1\n"
+							"test_values_bucket{le=\"3\"} 2\n"
+							"test_values_bucket{le=\"7\"} 2\n"
+							"test_values_bucket{le=\"15\"} 2\n"
+							"test_values_bucket{le=\"31\"} 2\n"
+							"test_values_bucket{le=\"63\"} 2\n"
+							"test_values_bucket{le=\"127\"} 3\n"
+							"test_values_bucket{le=\"+Inf\"} 3\n"
+							"test_values_sum 103\n"
+							"test_values_count 3\n"));
+		},
+		[]() {
+			// the file is written once more when the exporter is destroyed
+			auto registry = cspc::metrics_registry{};
+			example_registry(registry);
+			{
+				const auto exporter = cspc::metrics_file_exporter(
+					registry, metrics_path(), std::chrono::milliseconds(1000));
+			}
+			auto contents = std::stringstream{};
+			contents << std::ifstream(metrics_path()).rdbuf();
+			std::filesystem::remove(metrics_path());
+			return test_eq(contents.str(), registry.prometheus_text());
+		},
+		[]() {
+			auto registry = cspc::metrics_registry{};
+			example_registry(registry);
+			auto exporter = cspc::metrics_socket_exporter(registry);
+			exporter.listen(metrics_path());
+			const auto fd = gautil::connect_unix_socket(metrics_path());
+			auto contents = std::string{};
+			auto buffer = std::array<char, 256>{};
+			for (auto n_read = ssize_t(0);
+				 fd.has_value() && (n_read = ::read(fd.value(), buffer.data(), buffer.size())) > 0;) {
+				contents.append(buffer.data(), size_t(n_read));
+			}
+			if (fd.has_value()) {
+				::close(fd.value());
+			}
+			return test_eq(contents, registry.prometheus_text());
+		},
+	},
+};
+
+const auto test_metrics_instrumentation = TestSingle{
+	"metrics instrumentation",
+	[]() {
+		// the library records into the global registry, so only the increase is compared
+		auto& n_satisfiable = cspc::global_metrics().counter(
+			"cspc_kissat_results_total", "", {{"result", "satisfiable"}});
+		auto& n_unsatisfiable = cspc::global_metrics().counter(
+			"cspc_kissat_results_total", "", {{"result", "unsatisfiable"}});
+		const auto before = n_satisfiable.value() + n_unsatisfiable.value();
+		const auto checker = cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+			cspc::kissat_is_satisfiable);
+		checker(cspc::neq_relation(2, 2));
+		checker(cspc::neq_relation(2, 3));
+		return test_eq(n_satisfiable.value() + n_unsatisfiable.value() - before, u64(2));
+	},
+};
+} // namespace
+
+const TestModule test_metrics = {
+	.description = "metrics tests",
+	.tests =
+		{
+			test_metrics_export,
+			test_metrics_instrumentation,
+		},
+};
@@ -1,7 +1,11 @@
 #include "test_polymorphisms.hpp"
 
 #include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/encodings/label_cover.hpp>
 #include <cspc/formatters.hpp>
+#include <cspc/kissat.hpp>
+#include <gautil/formatters.hpp>
 
 namespace {
 const auto test_index_to_function_input = TestSingle{
@@ -74,6 +78,114 @@ const auto test_apply_identity_rare = TestBundle{
 		},
 	},
 };
+
+const auto test_identities_with_variables = TestBundle{
+	"identities with variables",
+	{
+		[]() {
+			const auto has_majority_operation = cspc::create_encoding_solver(
+				cspc::majority_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable);
+			return test_eq(
+				std::vector{
+					has_majority_operation(cspc::neq_relation(2, 2)),
+					has_majority_operation(cspc::neq_relation(2, 3)),
+				},
+				std::vector{cspc::SATISFIABLE, cspc::UNSATISFIABLE});
+		},
+		[]() {
+			const auto has_maltsev_operation = cspc::create_encoding_solver(
+				cspc::maltsev_operation(), cspc::direct_encoding, cspc::kissat_is_satisfiable);
+			const auto boolean_or = cspc::relation{{0, 1}, {1, 0}, {1, 1}};
+			return test_eq(
+				std::vector{
+					has_maltsev_operation(cspc::neq_relation(2, 2)),
+					has_maltsev_operation(boolean_or),
+				},
+				std::vector{cspc::SATISFIABLE, cspc::UNSATISFIABLE});
+		},
+	},
+};
+
+template <typename Encoding>
+auto test_multi_operation_checker(std::string const& name, Encoding encoding) -> TestSingle {
+	return TestSingle{
+		name,
+		[encoding]() {
+			const auto operations = std::vector<cspc::operation>{
+				cspc::siggers_operation(),
+				cspc::majority_operation(),
+				cspc::maltsev_operation(),
+				cspc::cyclic_operation(3),
+			};
+			const auto check_all = cspc::create_multi_encoding_solver(
+				operations, encoding, cspc::kissat_is_satisfiable);
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto actual = std::vector<cspc::satisfiability>{};
+			for (auto const& relation : cspc::all_nary_relations(2, 3)) {
+				std::ranges::transform(
+					operations, std::back_inserter(expected), [&](auto const& operation) {
+						return cspc::create_encoding_solver(
+							operation, encoding, cspc::kissat_is_satisfiable)(relation);
+					});
+				std::ranges::copy(check_all(relation), std::back_inserter(actual));
+			}
+			return test_eq(actual, expected);
+		},
+	};
+}
+
+// formatted with the tags, which the csp formatter leaves out
+auto describe(cspc::csp const& csp) -> std::vector<std::string> {
+	auto result = std::vector<std::string>{};
+	std::ranges::transform(csp.constraints(), std::back_inserter(result), [](auto const& c) {
+		return fmt::format("{} {}", c, int(c.tag()));
+	});
+	return result;
+}
+
+const auto test_parallel_construction = TestSingle{
+	"parallel meta-CSP construction",
+	[]() {
+		const auto operations = std::vector<cspc::operation>{
+			cspc::siggers_operation(),
+			cspc::majority_operation(),
+			cspc::cyclic_operation(3),
+		};
+		auto relations = cspc::all_nary_relations(2, 2);
+		relations.push_back(cspc::neq_relation(2, 3));
+		relations.push_back(cspc::relation{{0, 1}, {1, 0}, {1, 1}});
+		relations.push_back(cspc::relation{});
+		auto expected = std::vector<std::string>{};
+		auto actual = std::vector<std::string>{};
+		for (auto const& operation : operations) {
+			for (auto const& relation : relations) {
+				const auto serial =
+					describe(cspc::construct_preserves_operation_csp(operation, relation));
+				for (const auto n_threads : {2ul, 5ul, 64ul}) {
+					const auto parallel = describe(
+						cspc::construct_preserves_operation_csp(operation, relation, n_threads));
+					std::ranges::copy(serial, std::back_inserter(expected));
+					std::ranges::copy(parallel, std::back_inserter(actual));
+				}
+			}
+		}
+		return test_eq(actual, expected);
+	},
+};
+
+const auto test_sorted_construction = TestSingle{
+	"meta-CSP relations are sorted",
+	[]() {
+		// the encodings compare and hash the relation of every constraint, cheaply once sorted
+		const auto relation = cspc::relation{{1, 0}, {0, 1}, {1, 0}};
+		const auto csp =
+			cspc::construct_preserves_operation_csp(cspc::majority_operation(), relation);
+		return test_eq(
+			std::ranges::all_of(
+				csp.constraints(), [](auto const& c) { return c.get_relation().is_sorted(); }),
+			true);
+	},
+};
 } // namespace
 
 const TestModule test_polymorphisms = {
@@ -84,5 +196,12 @@ const TestModule test_polymorphisms = {
 			test_function_input_to_index,
 			test_satisfies_identity_rare,
 			test_apply_identity_rare,
+			test_identities_with_variables,
+			test_multi_operation_checker(
+				"multi operation checker direct encoding", cspc::direct_encoding),
+			test_multi_operation_checker(
+				"multi operation checker label cover encoding", cspc::label_cover_encoding),
+			test_parallel_construction,
+			test_sorted_construction,
 		},
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "test_relation.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/formatters.hpp>
+#include <cspc/intern.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+const auto test_relation_order = TestBundle{
+	"relation entry order",
+	{
+		[]() {
+			return test_eq(
+				std::vector<bool>{
+					cspc::relation_entry{0, 2} < cspc::relation_entry{1, 0},
+					cspc::relation_entry{1, 0} > cspc::relation_entry{0, 2},
+					cspc::relation_entry{2} < cspc::relation_entry{0, 0},
+					cspc::relation_entry{1, 1} <= cspc::relation_entry{1, 1},
+					cspc::relation_entry{1, 1} > cspc::relation_entry{1, 1},
+				},
+				std::vector<bool>{true, true, true, true, false});
+		},
+	},
+};
+
+const auto test_relation_hash = TestBundle{
+	"relation hash",
+	{
+		[]() {
+			const auto lhs = cspc::relation{{0, 1}, {1, 0}, {2, 2}};
+			const auto rhs = cspc::relation{{2, 2}, {0, 1}, {1, 0}};
+			return test_eq(
+				std::vector<bool>{
+					lhs == rhs,
+					std::hash<cspc::relation>{}(lhs) == std::hash<cspc::relation>{}(rhs),
+				},
+				std::vector<bool>{true, true});
+		},
+		[]() {
+			// every binary relation on three values hashes differently
+			auto hashes = std::vector<size_t>{};
+			for (auto const& relation : cspc::all_nary_relations(2, 3)) {
+				hashes.push_back(std::hash<cspc::relation>{}(relation));
+			}
+			std::ranges::sort(hashes);
+			return test_eq(std::ranges::adjacent_find(hashes) == hashes.end(), true);
+		},
+		[]() {
+			return test_eq(
+				cspc::relation{{0, 1}, {1, 0}} == cspc::relation{{0, 1}, {1, 1}}, false);
+		},
+		[]() {
+			// duplicate entries do not change the set
+			const auto lhs = cspc::relation{{0, 1}, {0, 1}, {1, 0}};
+			const auto rhs = cspc::relation{{1, 0}, {0, 1}};
+			auto sorted = lhs;
+			sorted.sort();
+			return test_eq(
+				std::vector<bool>{
+					lhs == rhs,
+					sorted == rhs,
+					std::hash<cspc::relation>{}(lhs) == std::hash<cspc::relation>{}(rhs),
+					std::hash<cspc::relation>{}(sorted) == std::hash<cspc::relation>{}(rhs),
+				},
+				std::vector<bool>{true, true, true, true});
+		},
+	},
+};
+
+const auto test_sorted_relation = TestBundle{
+	"sorted relation",
+	{
+		[]() {
+			auto relation = cspc::relation{{2, 0}, {0, 1}, {2, 0}, {1, 1}};
+			relation.sort();
+			return test_eq(relation.data(), cspc::relation{{0, 1}, {1, 1}, {2, 0}}.data());
+		},
+		[]() {
+			auto relation = cspc::relation{{2, 0}, {0, 1}};
+			relation.sort();
+			relation.insert({1, 2});
+			relation.insert({0, 1});
+			relation.erase({2, 0});
+			relation.erase({2, 2});
+			return test_eq(relation.data(), cspc::relation{{0, 1}, {1, 2}}.data());
+		},
+		[]() {
+			auto unsorted = cspc::neq_relation(3, 3);
+			auto sorted = unsorted;
+			sorted.sort();
+			auto expected = std::vector<bool>{};
+			auto actual = std::vector<bool>{};
+			for (auto const& tuple : cspc::create_all_tuples(3, 3)) {
+				expected.push_back(unsorted.contains(tuple));
+				actual.push_back(sorted.contains(tuple));
+			}
+			return test_eq(actual, expected);
+		},
+	},
+};
+
+const auto test_intern = TestSingle{
+	"intern relations",
+	[]() {
+		const auto n_before = cspc::n_interned_relations();
+		const auto lhs = cspc::intern(cspc::relation{{1, 0}, {0, 1}, {0, 2}});
+		const auto rhs = cspc::intern(cspc::relation{{0, 2}, {1, 0}, {0, 1}});
+		const auto other = cspc::intern(cspc::relation{{0, 2}, {1, 0}});
+		return test_eq(
+			std::vector<bool>{
+				lhs == rhs,
+				&lhs.get() == &rhs.get(),
+				lhs == other,
+				lhs->is_sorted(),
+				lhs->contains({0, 2}),
+				cspc::n_interned_relations() == n_before + 2,
+			},
+			std::vector<bool>{true, true, false, true, true, true});
+	},
+};
+} // namespace
+
+const TestModule test_relation = {
+	.description = "relation tests",
+	.tests =
+		{
+			test_relation_order,
+			test_relation_hash,
+			test_sorted_relation,
+			test_intern,
+		},
+};
@@ -0,0 +1,102 @@
+#include "test_results.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/results.hpp>
+#include <fstream>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto results_path() -> std::filesystem::path {
+	return std::filesystem::temp_directory_path() / "cspc_test_results.bin";
+}
+
+auto record_fields(cspc::result_record const& record) -> std::vector<u64> {
+	return {
+		record.classification, record.solve_time_ns, record.n_clauses,
+		record.fast_path_rule.value_or(99)};
+}
+
+const auto test_results_round_trip = TestBundle{
+	"results round trip",
+	{
+		[]() {
+			// neighboring records share a word of the class column
+			auto fields = std::vector<std::vector<u64>>{};
+			{
+				const auto store = cspc::result_store::create(results_path(), 70);
+				store->set(
+					33, cspc::result_record{cspc::NP_HARD, 1500, 12, std::nullopt});
+				store->set(32, cspc::result_record{cspc::POLYNOMIAL, 10, 0, 2});
+				store->set(34, cspc::result_record{cspc::POLYNOMIAL, 20, 3, std::nullopt});
+				store->set(33, cspc::result_record{cspc::POLYNOMIAL, 1500, 12, std::nullopt});
+			}
+			const auto store = cspc::result_store::open(results_path());
+			for (auto i = size_t(31); i < 36; ++i) {
+				fields.push_back(record_fields(store->get(i)));
+			}
+			std::filesystem::remove(results_path());
+			return test_eq(
+				fields, std::vector<std::vector<u64>>{
+							{0, 0, 0, 99},
+							{1, 10, 0, 2},
+							{1, 1500, 12, 99},
+							{1, 20, 3, 99},
+							{0, 0, 0, 99}});
+		},
+		[]() {
+			{
+				auto ofs = std::ofstream(results_path());
+				ofs << std::string(128, 'x');
+			}
+			const auto store = cspc::result_store::open(results_path());
+			std::filesystem::remove(results_path());
+			return test_eq(store == nullptr, true);
+		},
+	},
+};
+
+const auto test_results_recording = TestSingle{
+	"results recording",
+	[]() {
+		const auto relations = cspc::all_nary_relations(2, 2);
+		const auto store = std::shared_ptr<cspc::result_store>(
+			cspc::result_store::create(results_path(), relations.size()));
+		const auto recording = cspc::create_recording_checker(
+			cspc::default_fast_path_rules(), cspc::multivalued_direct_encoding,
+			cspc::kissat_is_satisfiable, store);
+		const auto plain = cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+			cspc::kissat_is_satisfiable);
+		// the returned results and the class counts of the summary, then the fast path hits
+		auto recorded = std::vector<size_t>(4);
+		auto expected = std::vector<size_t>(4);
+		for (auto i = size_t(0); i < relations.size(); ++i) {
+			recording(i, relations[i]);
+			++expected[cspc::to_relation_class(plain(relations[i]))];
+		}
+		const auto summary = cspc::summarize_results(*store, 0, store->size());
+		std::filesystem::remove(results_path());
+		std::ranges::copy(summary.class_counts, recorded.begin());
+		for (auto const count : summary.fast_path_counts) {
+			recorded[3] += count;
+		}
+		expected[3] = std::ranges::count_if(relations, [&](cspc::relation const& _relation) {
+			return cspc::classify_fast_path(
+					   cspc::siggers_operation(), _relation, cspc::default_fast_path_rules())
+				.has_value();
+		});
+		return test_eq(recorded, expected);
+	},
+};
+} // namespace
+
+const TestModule test_results = {
+	.description = "results tests",
+	.tests =
+		{
+			test_results_round_trip,
+			test_results_recording,
+		},
+};
@@ -0,0 +1,87 @@
+#include "test_sweep.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/sweep.hpp>
+#include <gautil/formatters.hpp>
+#include <gautil/system.hpp>
+#include <sys/wait.h>
+
+namespace {
+const auto test_shard_range = TestBundle{
+	"shard range",
+	{
+		[]() {
+			auto covered = std::vector<size_t>{};
+			for (auto i = size_t(0); i < 4; ++i) {
+				const auto shard = cspc::shard_range(10, i, 4);
+				covered.push_back(shard.begin);
+				covered.push_back(shard.end);
+			}
+			return test_eq(covered, std::vector<size_t>{0, 3, 3, 6, 6, 8, 8, 10});
+		},
+		[]() {
+			const auto shard = cspc::shard_range(2, 3, 4);
+			return test_eq(std::vector{shard.begin, shard.end}, std::vector<size_t>{2, 2});
+		},
+	},
+};
+
+const auto test_shard_round_trip = TestSingle{
+	"shard round trip",
+	[]() {
+		const auto directory = std::filesystem::temp_directory_path() / "cspc_test_sweep";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+
+		const auto relations = cspc::all_nary_relations(2, 3);
+		const auto checker = cspc::create_encoding_solver(
+			cspc::siggers_operation(), cspc::multivalued_direct_encoding,
+			cspc::kissat_is_satisfiable);
+		constexpr auto N_SHARDS = 3;
+		for (auto i = size_t(0); i < N_SHARDS; ++i) {
+			cspc::run_shard(
+				relations, cspc::shard_range(relations.size(), i, N_SHARDS), checker, directory);
+		}
+
+		auto expected = std::vector<cspc::satisfiability>{};
+		std::ranges::transform(relations, std::back_inserter(expected), checker);
+		const auto merged = cspc::merge_shard_results(directory, N_SHARDS, relations.size());
+		std::filesystem::remove_all(directory);
+		return test_eq(merged, std::optional{expected});
+	},
+};
+
+const auto test_supervise_shards = TestSingle{
+	"supervise shards",
+	[]() {
+		// a child the supervisor did not spawn is left for its owner to wait for
+		const auto directory = std::filesystem::temp_directory_path() / "cspc_test_supervise";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		const auto other_child = gautil::spawn({"true"});
+		const auto supervised = cspc::supervise_shards(
+			3, directory,
+			[&](size_t shard_index) {
+				return std::vector<std::string>{
+					"touch", cspc::shard_result_path(directory, shard_index).string()};
+			},
+			cspc::supervisor_options{.n_workers = 1, .max_restarts = 0});
+		auto status = int{0};
+		const auto waited = waitpid(other_child.value(), &status, 0) == other_child.value();
+		std::filesystem::remove_all(directory);
+		return test_eq(std::vector{supervised, waited}, std::vector{true, true});
+	},
+};
+} // namespace
+
+const TestModule test_sweep = {
+	.description = "sweep tests",
+	.tests =
+		{
+			test_shard_range,
+			test_shard_round_trip,
+			test_supervise_shards,
+		},
+};
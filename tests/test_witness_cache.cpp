@@ -0,0 +1,104 @@
+#include "test_witness_cache.hpp"
+
+#include <cspc/algorithms.hpp>
+#include <cspc/encodings/binary.hpp>
+#include <cspc/encodings/direct.hpp>
+#include <cspc/kissat.hpp>
+#include <cspc/witness_cache.hpp>
+#include <gautil/formatters.hpp>
+
+namespace {
+auto first_projection(size_t arity, size_t domain_size) -> cspc::function_table {
+	auto table = cspc::function_table{
+		arity, domain_size, std::vector<cspc::domain_value>(std::pow(domain_size, arity))};
+	for (auto k = cspc::domain_value(0); k < table.values.size(); ++k) {
+		table.values[k] = cspc::__internal::index_to_function_input(k, arity, domain_size)[0];
+	}
+	return table;
+}
+
+const auto test_preserves = TestBundle{
+	"preserves",
+	{
+		[]() {
+			return test_eq(
+				cspc::preserves(first_projection(4, 3), cspc::neq_relation(2, 3)), true);
+		},
+		[]() {
+			return test_eq(
+				cspc::preserves(first_projection(2, 2), cspc::neq_relation(3, 3)), false);
+		},
+		[]() {
+			const auto constant = cspc::function_table{2, 2, {1, 1, 1, 1}};
+			return test_eq(cspc::preserves(constant, cspc::neq_relation(2, 2)), false);
+		},
+		[]() {
+			const auto constant = cspc::function_table{2, 2, {1, 1, 1, 1}};
+			return test_eq(cspc::preserves(constant, cspc::relation{{0, 1}, {1, 1}}), true);
+		},
+	},
+};
+
+template <typename Encoding, typename Decoder>
+auto test_witness_caching_solver(std::string const& name, Encoding encoding, Decoder decoder)
+	-> TestSingle {
+	return TestSingle{
+		name,
+		[encoding, decoder]() {
+			const auto checker = cspc::create_encoding_solver(
+				cspc::siggers_operation(), encoding, cspc::kissat_is_satisfiable);
+			const auto cache = std::make_shared<cspc::witness_cache>(8);
+			const auto caching_checker = cspc::create_witness_caching_solver(
+				cspc::siggers_operation(), encoding, decoder, cspc::kissat_find_model, cache);
+
+			auto expected = std::vector<cspc::satisfiability>{};
+			auto actual = std::vector<cspc::satisfiability>{};
+			for (auto const& relations :
+				 {cspc::all_nary_relations(2, 3), cspc::all_nary_relations(3, 2)}) {
+				std::ranges::transform(relations, std::back_inserter(expected), checker);
+				std::ranges::transform(relations, std::back_inserter(actual), caching_checker);
+			}
+			return test_eq(
+				std::vector<bool>{actual == expected, cache->hits() > 0},
+				std::vector<bool>{true, true});
+		},
+	};
+}
+
+const auto test_shared_witness_cache = TestSingle{
+	"witness cache shared between operations",
+	[]() {
+		// a majority operation preserves boolean or, a Maltsev operation does not
+		const auto cache = std::make_shared<cspc::witness_cache>(8);
+		const auto create_checker = [&](cspc::operation const& operation) {
+			return cspc::create_witness_caching_solver(
+				operation, cspc::direct_encoding, cspc::decode_direct_assignment,
+				cspc::kissat_find_model, cache);
+		};
+		const auto has_majority_operation = create_checker(cspc::majority_operation());
+		const auto has_maltsev_operation = create_checker(cspc::maltsev_operation());
+		const auto boolean_or = cspc::relation{{0, 1}, {1, 0}, {1, 1}};
+		return test_eq(
+			std::vector{has_majority_operation(boolean_or), has_maltsev_operation(boolean_or)},
+			std::vector{cspc::SATISFIABLE, cspc::UNSATISFIABLE});
+	},
+};
+} // namespace
+
+const TestModule test_witness_cache = {
+	.description = "witness cache tests",
+	.tests =
+		{
+			test_preserves,
+			test_witness_caching_solver(
+				"witness caching solver direct encoding", cspc::direct_encoding,
+				cspc::decode_direct_assignment),
+			test_witness_caching_solver(
+				"witness caching solver multivalued direct encoding",
+				cspc::multivalued_direct_encoding, cspc::decode_direct_assignment),
+			test_witness_caching_solver(
+				"witness caching solver log encoding", cspc::log_encoding,
+				cspc::decode_binary_assignment),
+			test_shared_witness_cache,
+		},
+};